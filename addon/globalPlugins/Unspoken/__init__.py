@@ -8,9 +8,8 @@ import os.path
 import sys
 import time
 import threading
-import wave
-import struct
 import globalPluginHandler
+import globalVars
 import NVDAObjects
 import config
 import speech
@@ -24,6 +23,26 @@ import wx
 import nvwave
 from synthDriverHandler import synthChanged
 
+from scriptHandler import script
+
+from .audio_worker import (
+    PRIORITY_DEPTHS,
+    PRIORITY_FOCUS,
+    PRIORITY_MOUSE,
+    PRIORITY_NAVIGATOR,
+    AudioWorker,
+)
+from .device_output import DeviceOutput, device_mix_rate
+from .disk_cache import DiskRenderCache
+from .geometry import DesktopGeometry
+from .latency import DurationStats, LatencyStats, LatencyTrace, last_lock_acquired
+from .locations import LocationCache
+from .memory import format_memory_report, working_set_bytes
+from .mixer import LoopbackMixer
+from .prewarm import CachePrewarmer
+from .spatial import ScreenMap
+from .throttle import EventThrottle
+
 # openal_audio wraps soft_oal.dll via ctypes; import failure means DLL is missing.
 # The HRTF config checkbox adjusts source gain by +0.25; it does not disable HRTF rendering.
 try:
@@ -85,6 +104,23 @@ sound_files = {
 
 sounds = dict()  # For holding instances in RAM.
 
+# Roles whose sounds are pre-rendered into the render cache, most common first.
+prewarm_roles = (
+    controlTypes.ROLE_BUTTON,
+    controlTypes.ROLE_LISTITEM,
+    controlTypes.ROLE_MENUITEM,
+    controlTypes.ROLE_EDITABLETEXT,
+    controlTypes.ROLE_CHECKBOX,
+)
+
+
+# Main-thread extractions slower than this (seconds) are logged when timed.
+SLOW_EXTRACTION = 0.02
+
+# How long terminate() waits for the engine to finish loading (seconds). The init
+# thread opens the output device, so a hung audio driver must not hang NVDA's exit.
+INIT_JOIN_TIMEOUT = 5.0
+
 
 # taken from Stackoverflow. Don't ask.
 def clamp(my_value, min_value, max_value):
@@ -94,6 +130,7 @@ def clamp(my_value, min_value, max_value):
 class GlobalPlugin(globalPluginHandler.GlobalPlugin):
     def __init__(self, *args, **kwargs):
         super(GlobalPlugin, self).__init__(*args, **kwargs)
+        init_start = time.perf_counter()
         from . import addonGui
 
         gui.settingsDialogs.NVDASettingsDialog.categoryClasses.append(
@@ -105,36 +142,74 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
             "noSounds": "boolean(default=False)",
             "HRTF": "boolean(default=True)",
             "volumeAdjust": "boolean(default=True)",
+            # Place objects covering much of the screen farther away (quieter)
+            "sizeAsDistance": "boolean(default=False)",
             "Reverb": "boolean(default=True)",
+            # v1's verblib reverb (native, needs spatializer.dll) instead of EFX
+            "classicReverb": "boolean(default=False)",
             "RoomSize": "integer(default=10, min=0, max=100)",
             "Damping": "integer(default=100, min=0, max=100)",
             "WetLevel": "integer(default=9, min=0, max=100)",
             "DryLevel": "integer(default=30, min=0, max=100)",
             "Width": "integer(default=100, min=0, max=100)",
+            # Reverb tails are cut once they stay this many dB below full scale
+            "TailFloor": "integer(default=60, min=30, max=96)",
+            "streamRender": "boolean(default=False)",
+            "mixSounds": "boolean(default=False)",
+            # Keep one WavePlayer stream open, fed by the mixer even when silent
+            "alwaysOn": "boolean(default=False)",
+            # Play through the mixer so every sound sends into one persistent
+            # reverb and tails carry on under the next sound
+            "sharedReverb": "boolean(default=False)",
+            # Background render cache pre-warming: CPU share in percent of one
+            # core, and megabytes of renders added per pass
+            "prewarm": "boolean(default=True)",
+            "PrewarmCPU": "integer(default=25, min=5, max=100)",
+            "PrewarmMemory": "integer(default=8, min=1, max=32)",
+            # Keep renders in a file in the NVDA config directory between
+            # sessions; takes effect at the next start
+            "diskCache": "boolean(default=False)",
+            # Render at the output device's mix rate, read at startup, so neither
+            # OpenAL nor Windows resamples; 44.1 kHz otherwise
+            "matchDeviceRate": "boolean(default=True)",
+            # Play on an OpenAL Soft device instead of nvwave (no ducking); takes
+            # effect once the engine is up and on every synth change
+            "directOutput": "boolean(default=False)",
+            # Minimum ms between sounds from each event source, and whether a
+            # source waits for its events to stop before playing; see throttle.py
+            "MouseInterval": "integer(default=50, min=0, max=1000)",
+            "mouseSettle": "boolean(default=False)",
+            "NavigatorInterval": "integer(default=0, min=0, max=1000)",
+            "navigatorSettle": "boolean(default=False)",
+            "FocusInterval": "integer(default=0, min=0, max=1000)",
+            "focusSettle": "boolean(default=False)",
+            # Time every main-thread extraction, including events that play nothing
+            "timeExtraction": "boolean(default=False)",
         }
-        log.debug("Initializing OpenAL audio engine", exc_info=True)
-        self.audio_engine = openal_audio.get_openal_audio()
-        if not self.audio_engine.initialize():
-            log.error("Failed to initialize OpenAL audio engine")
-            raise RuntimeError("OpenAL audio engine initialization failed")
-
-        # Configure reverb settings
-        self.audio_engine.set_reverb_settings(
-            room_size=config.conf["unspoken"]["RoomSize"] / 100.0,
-            damping=config.conf["unspoken"]["Damping"] / 100.0,
-            wet_level=config.conf["unspoken"]["WetLevel"] / 100.0,
-            dry_level=config.conf["unspoken"]["DryLevel"] / 100.0,
-            width=config.conf["unspoken"]["Width"] / 100.0,
-        )
-        self.audio_engine.enable_reverb(config.conf["unspoken"]["Reverb"])
-
-        self.make_sound_objects()
-
-        # Initialize WavePlayer for audio output (stereo, 44100Hz, 16-bit)
+        # The OpenAL engine, the sound bank, the pre-warmer and (if always-on) the
+        # mixer are set up by _init_engine on a background thread so NVDA startup
+        # does not wait for the DLL, the loopback contexts and the wav decoding.
+        # Until _engine_ready is set no earcons play, and since sounds is still
+        # empty NVDA keeps speaking roles.
+        self.audio_engine = None
+        self._prewarmer = None
+        self._mixer = None
+        self._engine_ready = threading.Event()
+        sounds.clear()
+
+        # Initialize WavePlayer for audio output (stereo, 44100Hz, 16-bit); reopened
+        # by _init_engine if the engine runs at another rate
         self.create_wave_player()
         # Hook to keep NVDA from announcing roles.
         self._NVDA_getSpeechTextForProperties = speech.speech.getPropertiesSpeech
         speech.speech.getPropertiesSpeech = self._hook_getSpeechTextForProperties
+        # Hooks to hear navigator moves as they happen: object navigation sets the
+        # navigator directly, review and browse mode caret moves set the review
+        # position, which clears the navigator until it is next read.
+        self._NVDA_setNavigatorObject = api.setNavigatorObject
+        api.setNavigatorObject = self._hook_setNavigatorObject
+        self._NVDA_setReviewPosition = api.setReviewPosition
+        api.setReviewPosition = self._hook_setReviewPosition
 
         self._previous_mouse_object = None
         self._last_played_object = None
@@ -142,69 +217,192 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
         self._last_navigator_object = None
         self._wave_player_lock = threading.Lock()
         self._sound_generation = 0
-
+        # Newest generation submitted in each priority class; a sound is only
+        # superseded by a newer one of its own class or a more important one
+        self._class_generations = [0] * len(PRIORITY_DEPTHS)
+        # (generation, priority, end) of the sound being heard, end being None
+        # while the playback worker plays it; see _yields
+        self._playing = None
+        # Sounds dropped because a more important one was still being heard
+        self._yielded = 0
+        # Sounds dropped because a newer one superseded them
+        self._dropped_stale = 0
+        # Rate limits per event source in front of the main-thread extraction.
+        self._throttles = {
+            "mouse": EventThrottle(
+                # Sounds under a moving mouse overlap rather than cut each other off
+                lambda obj: self._play_object_async(obj, interrupt=False, priority=PRIORITY_MOUSE),
+                wx.CallLater,
+            ),
+            # Submitted without an object; the navigator is read when it fires
+            "navigator": EventThrottle(self._play_navigator, wx.CallLater),
+            "focus": EventThrottle(self._play_object_async, wx.CallLater),
+        }
+        # Event-to-first-feed timings; logged with NVDA+control+shift+u.
+        self._latency = LatencyStats()
+        self._extract_times = DurationStats("main thread extraction")
+        self._locations = LocationCache()
+        # Persistent render and playback threads; see audio_worker.py.
+        self._render_worker = AudioWorker(
+            self._render_request, name="UnspokenRenderWorker", depths=PRIORITY_DEPTHS
+        )
+        self._playback_worker = AudioWorker(
+            self._playback_request, name="UnspokenPlaybackWorker"
+        )
         # Cached values to reduce main-thread blocking during sound playback.
-        # Desktop dimensions change rarely (monitor changes); refresh every 5 seconds.
+        # The monitor layout is re-read only on display changes (geometry.py).
         # Volume changes only when synth changes; refresh in on_synthChanged.
-        self._cached_desktop_size = None  # (max_x, max_y)
-        self._desktop_cache_time = 0
         self._cached_volume = 1.0
-        self._update_desktop_cache()
+        # Screen position to spatial cell lookup, rebuilt when the monitor layout changes
+        self._screen_map = ScreenMap()
+        self._geometry = DesktopGeometry(fallback=self._desktop_rect)
+        self._geometry.add_listener(self._screen_map.set_monitors)
+        self._geometry.refresh()
+        self._geometry.watch(gui.mainFrame)
         self._update_volume_cache()
 
-        # Lightweight timer to check arrow key navigation
-        self._navigation_timer = wx.Timer()
-        self._navigation_timer.Bind(wx.EVT_TIMER, self._onNavigationTimer)
-        self._navigation_timer.Start(100)  # Check every 100ms
-
-        # these are in degrees.
-        self._display_width = 180.0
-        self._display_height_min = -40.0
-        self._display_height_magnitude = 50.0
         synthChanged.register(self.on_synthChanged)
 
+        # Set by terminate(); an init thread still running then releases the engine itself
+        self._terminating = False
+        self._init_thread = threading.Thread(
+            target=self._init_engine, name="UnspokenInit", daemon=True
+        )
+        self._init_thread.start()
+        log.debug(
+            f"Unspoken plugin initialized in {(time.perf_counter() - init_start) * 1000.0:.1f} ms; "
+            "audio engine loading in the background"
+        )
+
+    def _init_engine(self):
+        """Initialize the OpenAL engine and load the sound bank (init thread)."""
+        started = time.perf_counter()
+        try:
+            engine = openal_audio.get_openal_audio()
+            if not engine.initialize(sample_rate=self._negotiate_sample_rate(engine)):
+                log.error("Failed to initialize OpenAL audio engine; Unspoken sounds are disabled")
+                return
+
+            # Configure reverb settings
+            engine.set_reverb_settings(
+                room_size=config.conf["unspoken"]["RoomSize"] / 100.0,
+                damping=config.conf["unspoken"]["Damping"] / 100.0,
+                wet_level=config.conf["unspoken"]["WetLevel"] / 100.0,
+                dry_level=config.conf["unspoken"]["DryLevel"] / 100.0,
+                width=config.conf["unspoken"]["Width"] / 100.0,
+            )
+            engine.enable_reverb(config.conf["unspoken"]["Reverb"])
+            engine.use_classic_reverb(config.conf["unspoken"]["classicReverb"])
+            engine.set_tail_floor(-config.conf["unspoken"]["TailFloor"])
+
+            role_sounds = self.make_sound_objects(engine)
+            if config.conf["unspoken"]["diskCache"]:
+                # Opened lazily by the first lookup, on the render worker
+                engine.attach_disk_cache(
+                    DiskRenderCache(
+                        os.path.join(globalVars.appArgs.configPath, "unspoken_render_cache.bin"),
+                        engine.disk_fingerprint(),
+                    )
+                )
+            self.audio_engine = engine
+
+            # Fills the render cache in the background at startup and whenever reverb
+            # settings change; see prewarm.py. Not worth it with only the primary
+            # context, whose streams and mixer it would have to wait behind.
+            if engine.has_background_context:
+                self._prewarmer = CachePrewarmer(
+                    engine,
+                    [role_sounds[role] for role in prewarm_roles if role in role_sounds],
+                    lambda: self._cached_volume,
+                    cpu_budget=config.conf["unspoken"]["PrewarmCPU"] / 100.0,
+                    max_bytes=config.conf["unspoken"]["PrewarmMemory"] * 1024 * 1024,
+                )
+                engine.add_reverb_listener(self._restart_prewarm)
+            else:
+                log.debug("Unspoken cache pre-warm disabled: only one loopback context")
+            if (
+                config.conf["unspoken"]["directOutput"]
+                or engine.sample_rate != openal_audio.DEFAULT_SAMPLE_RATE
+            ):
+                # The WavePlayer opened at startup is replaced now the engine can open
+                # a device, or to match the engine's rate
+                with self._wave_player_lock:
+                    self.wave_player.close()
+                    self.create_wave_player()
+            # Continuous mixer for overlapping sounds; created on first use, or now
+            # if the always-on stream is enabled.
+            if config.conf["unspoken"]["alwaysOn"]:
+                self._get_mixer()
+        except Exception:
+            log.error("Unspoken audio engine initialization failed", exc_info=True)
+            return
+
+        if self._terminating:
+            # terminate() stopped waiting for this thread and left the engine to it
+            self._release_engine()
+            log.debug("Unspoken audio engine finished loading after the add-on was terminated")
+            return
+
+        # Publishing the roles is what turns role speech off and earcons on
+        sounds.update(role_sounds)
+        self._engine_ready.set()
+        self._restart_prewarm()
+        log.info(
+            f"Unspoken audio engine ready in {(time.perf_counter() - started) * 1000.0:.0f} ms "
+            f"({len(set(role_sounds.values()))} sound files for {len(role_sounds)} roles)"
+        )
+
+    @staticmethod
+    def _negotiate_sample_rate(engine):
+        """Pick the engine's output rate: the device's mix rate if loopback can render it."""
+        if engine.dll is None or not config.conf["unspoken"]["matchDeviceRate"]:
+            return openal_audio.DEFAULT_SAMPLE_RATE
+        try:
+            rate = device_mix_rate(engine.dll, config.conf["audio"]["outputDevice"])
+        except Exception:
+            log.debugWarning("Could not read the output device's mix rate", exc_info=True)
+            rate = None
+        if rate is None or not engine.supports_sample_rate(rate):
+            return openal_audio.DEFAULT_SAMPLE_RATE
+        log.debug(f"Rendering at the output device's mix rate of {rate} Hz")
+        return rate
+
     def create_wave_player(self):
+        if config.conf["unspoken"]["directOutput"] and self.audio_engine is not None:
+            player = DeviceOutput.open(
+                self.audio_engine, config.conf["audio"]["outputDevice"]
+            )
+            if player is not None:
+                self.wave_player = player
+                return
         self.wave_player = nvwave.WavePlayer(
             channels=2,
-            samplesPerSec=44100,
+            samplesPerSec=(
+                self.audio_engine.sample_rate
+                if self.audio_engine is not None
+                else openal_audio.DEFAULT_SAMPLE_RATE
+            ),
             bitsPerSample=16,
             outputDevice=config.conf["audio"]["outputDevice"],
         )
 
-    def make_sound_objects(self):
-        """Load sound files for OpenAL audio processing."""
+    def make_sound_objects(self, engine):
+        """Load each distinct sound file once into engine's sound bank.
+
+        Returns {role: sound bank id} for the roles whose file loaded.
+        """
         log.debug("Loading sound files for OpenAL audio engine", exc_info=True)
+        loaded = {}
+        role_sounds = {}
         for key, value in sound_files.items():
-            path = os.path.join(UNSPOKEN_SOUNDS_PATH, value)
-            log.debug("Loading " + path, exc_info=True)
-            try:
-                # Load WAV file and convert to float32 mono
-                with wave.open(path, "rb") as wav_file:
-                    frames = wav_file.readframes(wav_file.getnframes())
-                    sample_width = wav_file.getsampwidth()
-                    channels = wav_file.getnchannels()
-                    sample_rate = wav_file.getframerate()
-
-                    # Convert to float32 samples
-                    if sample_width == 2:  # 16-bit
-                        samples = struct.unpack(f"<{len(frames) // 2}h", frames)
-                        float_samples = [s / 32768.0 for s in samples]
-                    else:
-                        log.error(f"Unsupported sample width: {sample_width}")
-                        continue
-
-                    # Convert to mono if stereo
-                    if channels == 2:
-                        # Source WAV files are mono or have identical left/right channels;
-                        # if stereo, we take left channel only as it's sufficient
-                        float_samples = [
-                            float_samples[i] for i in range(0, len(float_samples), 2)
-                        ]
-
-                    sounds[key] = {"data": float_samples, "sample_rate": sample_rate}
-
-            except Exception as e:
-                log.error(f"Failed to load {path}: {e}")
+            if value not in loaded:
+                path = os.path.join(UNSPOKEN_SOUNDS_PATH, value)
+                log.debug("Loading " + path, exc_info=True)
+                loaded[value] = engine.load_sound(value, path)
+            if loaded[value]:
+                # Roles map to sound bank ids (the wav filename)
+                role_sounds[key] = value
+        return role_sounds
 
     def shouldNukeRoleSpeech(self):
         if config.conf["unspoken"]["sayAll"] and SayAllHandler.isRunning():
@@ -224,16 +422,33 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
                 del kwargs["role"]
         return self._NVDA_getSpeechTextForProperties(reason, *args, **kwargs)
 
-    def _onNavigationTimer(self, event):
-        """Timer to check navigator object changes without blocking"""
+    def _hook_setNavigatorObject(self, obj, *args, **kwargs):
+        result = self._NVDA_setNavigatorObject(obj, *args, **kwargs)
+        # Focus changes play from event_gainFocus
+        if not kwargs.get("isFocus", args[0] if args else False):
+            self._play_throttled("navigator", None)
+        return result
+
+    def _hook_setReviewPosition(self, reviewPosition, *args, **kwargs):
+        result = self._NVDA_setReviewPosition(reviewPosition, *args, **kwargs)
+        # Only moves that clear the navigator can change it; mouse-driven review
+        # moves play from event_mouseMove
+        clear_navigator = kwargs.get("clearNavigatorObject", args[0] if args else True)
+        is_mouse = kwargs.get("isMouse", args[2] if len(args) > 2 else False)
+        if clear_navigator and not is_mouse:
+            self._play_throttled("navigator", None)
+        return result
+
+    def _play_navigator(self, _obj=None):
+        """Play the navigator object if it changed since the last navigator sound."""
         try:
             current_nav = api.getNavigatorObject()
             if current_nav and current_nav != self._last_navigator_object:
                 self._last_navigator_object = current_nav
-                self._play_object_async(current_nav)
+                self._play_object_async(current_nav, priority=PRIORITY_NAVIGATOR)
         except Exception:
-            # Ignore any errors to avoid interrupting the timer
-            pass
+            # Never let a sound break NVDA's navigator/review commands
+            log.debugWarning("Unspoken navigator sound failed", exc_info=True)
 
     def _compute_volume(self):
         if not config.conf["unspoken"]["volumeAdjust"]:
@@ -247,32 +462,27 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
         """Update cached volume value. Called at init and when synth changes."""
         self._cached_volume = self._compute_volume()
 
-    def _update_desktop_cache(self):
-        """Update cached desktop dimensions. Called at init and lazily refreshed."""
-        desktop = NVDAObjects.api.getDesktopObject()
-        self._cached_desktop_size = (desktop.location[2], desktop.location[3])
-        self._desktop_cache_time = time.time()
-
-    def _get_desktop_size(self):
-        """Get desktop dimensions, refreshing cache if stale (>5 seconds)."""
-        if time.time() - self._desktop_cache_time > 5.0:
-            self._update_desktop_cache()
-        return self._cached_desktop_size
+    @staticmethod
+    def _desktop_rect():
+        """The desktop object's location; the geometry fallback if monitors cannot be enumerated."""
+        return NVDAObjects.api.getDesktopObject().location
 
     # CRITICAL: NVDA objects use COM single-threaded apartment model. All property
     # access (role, location, treeInterceptor.currentNVDAObject) MUST occur on the
-    # main thread before spawning background threads. Moving these accesses to
+    # main thread before handing work to the audio workers. Moving these accesses to
     # background threads will cause COM threading violations and crash NVDA.
     # This is why we use two-phase architecture: extract params on main thread
-    # (_extract_sound_params), then process audio on background thread (_play_sound_async).
+    # (_extract_sound_params), then process audio on the render worker (_play_sound_async).
     def _extract_sound_params(self, obj):
         """Extract NVDA object properties on main thread for sound playback.
 
-        Returns tuple (role, angle_x, angle_y, volume) or None if sound should not play.
-        Must be called from main thread before spawning background threads.
+        Returns tuple (role, angle_x, angle_y, distance, volume) or None if sound should not play.
+        Must be called from main thread before submitting to the render worker.
         """
         if config.conf["unspoken"]["noSounds"]:
             return None
+        if not self._engine_ready.is_set():
+            return None
         if config.conf["unspoken"]["sayAll"] and SayAllHandler.isRunning():
             return None
 
@@ -287,106 +497,354 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
         if role not in sounds:
             return None
 
-        # Get coordinate bounds of desktop (cached, refreshed every 5 seconds).
-        desktop_max_x, desktop_max_y = self._get_desktop_size()
-
-        # Get location of the object.
-        if obj.location != None and obj.treeInterceptor == None:
-            obj_x = obj.location[0] + (obj.location[2] / 2.0)
-            obj_y = obj.location[1] + (obj.location[3] / 2.0)
-        elif (
-            obj.treeInterceptor != None
-            and obj.treeInterceptor.currentNVDAObject != None
-            and obj.treeInterceptor.currentNVDAObject.location != None
-        ):
-            obj_x = obj.treeInterceptor.currentNVDAObject.location[0] + (
-                obj.treeInterceptor.currentNVDAObject.location[2] / 2.0
-            )
-            obj_y = obj.treeInterceptor.currentNVDAObject.location[1] + (
-                obj.treeInterceptor.currentNVDAObject.location[3] / 2.0
-            )
-        else:
-            obj_x = desktop_max_x / 2.0
-            obj_y = desktop_max_y / 2.0
+        # Map the object's location to its spatial cell (already quantized to
+        # the render cache grid) on the monitor it is on.
+        location = self._locations.get(obj, self._fetch_location)
+        angle_x, angle_y, distance = self._screen_map.locate(
+            location, config.conf["unspoken"]["sizeAsDistance"]
+        )
 
-        # Scale object position to audio display.
-        angle_x = ((obj_x - desktop_max_x / 2.0) / desktop_max_x) * self._display_width
+        # Use cached volume (updated at init and when synth changes)
+        return (role, angle_x, angle_y, distance, self._cached_volume)
 
-        percent = (desktop_max_y - obj_y) / desktop_max_y
-        angle_y = self._display_height_magnitude * percent + self._display_height_min
+    @staticmethod
+    def _fetch_location(obj):
+        """Return obj's (left, top, width, height) on screen, or None; reads each property once.
 
-        # Clamp angles to valid ranges.
-        angle_x = clamp(angle_x, -90.0, 90.0)
-        angle_y = clamp(angle_y, -90.0, 90.0)
+        Inside a document the location is that of the object at the browse mode caret.
+        """
+        tree_interceptor = obj.treeInterceptor
+        if tree_interceptor is None:
+            return obj.location
+        current = tree_interceptor.currentNVDAObject
+        if current is None:
+            return None
+        return current.location
 
-        # Use cached volume (updated at init and when synth changes)
-        return (role, angle_x, angle_y, self._cached_volume)
+    def _play_throttled(self, source, obj):
+        """Pass obj through source's EventThrottle, configured from the current settings."""
+        unspoken = config.conf["unspoken"]
+        if unspoken["noSounds"]:
+            return
+        throttle = self._throttles[source]
+        throttle.configure(
+            unspoken[source.capitalize() + "Interval"] / 1000.0,
+            unspoken[source + "Settle"],
+        )
+        throttle.submit(obj)
+
+    def _play_object_async(self, obj, interrupt=True, priority=PRIORITY_FOCUS):
+        """Extract params and post the sound to the render worker in a priority class.
 
-    def _play_object_async(self, obj):
-        """Extract params and play sound in background thread."""
+        In mixing mode, interrupt=False lets the sound overlap those already playing.
+        """
+        trace = LatencyTrace()
         params = self._extract_sound_params(obj)
+        if config.conf["unspoken"]["timeExtraction"]:
+            elapsed = time.perf_counter() - trace.marks["event"]
+            self._extract_times.record(elapsed)
+            if elapsed > SLOW_EXTRACTION:
+                log.debugWarning(f"Unspoken main thread extraction took {elapsed * 1000.0:.1f} ms")
         if params is not None:
-            role, angle_x, angle_y, volume = params
-            self._sound_generation += 1
-            my_generation = self._sound_generation
+            trace.mark("extracted")
+            role, angle_x, angle_y, distance, volume = params
+            if self._prewarmer is not None:
+                self._prewarmer.note_activity(sounds.get(role), angle_x, angle_y, distance)
+            generation = self._next_generation(priority)
+            # Replaces the oldest request of its class still waiting, and any
+            # less important ones
+            self._render_worker.submit(
+                (
+                    role,
+                    angle_x,
+                    angle_y,
+                    distance,
+                    volume,
+                    generation,
+                    priority,
+                    interrupt,
+                    trace,
+                ),
+                priority,
+            )
+
+    def _next_generation(self, priority):
+        """Number a new sound of the given priority class. Main thread only."""
+        self._sound_generation += 1
+        self._class_generations[priority] = self._sound_generation
+        return self._sound_generation
+
+    def _superseded(self, generation, priority):
+        """Whether a newer sound of this priority class or a more important one was submitted."""
+        return any(newer > generation for newer in self._class_generations[:priority + 1])
+
+    def _stale(self, generation, priority):
+        """_superseded, counting the sound as dropped if it is."""
+        if self._superseded(generation, priority):
+            self._dropped_stale += 1
+            return True
+        return False
+
+    def _yields(self, priority):
+        """Whether a sound of this priority must give way to a more important one still being heard."""
+        playing = self._playing
+        if playing is None:
+            return False
+        generation, playing_priority, end = playing
+        if playing_priority >= priority or self._superseded(generation, playing_priority):
+            return False
+        return end is None or time.perf_counter() < end
+
+    def _render_request(self, request):
+        self._play_sound_async(*request)
 
-            def play_async():
-                try:
-                    self._play_sound_async(role, angle_x, angle_y, volume, my_generation)
-                except Exception:
-                    pass
+    def _restart_prewarm(self):
+        """Start a pre-warm pass, unless disabled or sounds do not use the render cache."""
+        if self._prewarmer is None:
+            return
+        if config.conf["unspoken"]["prewarm"] and not self._uses_mixer():
+            self._prewarmer.restart()
 
-            threading.Thread(target=play_async, daemon=True).start()
+    @staticmethod
+    def _uses_mixer():
+        """Whether sounds play on the mixer's voice pool instead of being rendered one by one.
 
-    def _play_sound_async(self, role, angle_x, angle_y, volume, generation):
-        """Process and play sound on background thread using pre-extracted parameters.
+        Besides overlapping and always-on playback, this is the shared reverb: the
+        voices all send into the primary context's one effect slot (or its classic
+        reverb), so the tail is rendered once per mixer block, carries on when a new
+        sound interrupts the last, and no sound pays for a private tail render.
+        """
+        unspoken = config.conf["unspoken"]
+        return (
+            unspoken["mixSounds"]
+            or unspoken["alwaysOn"]
+            or (unspoken["sharedReverb"] and unspoken["Reverb"])
+        )
+
+    def _get_mixer(self):
+        """Return the continuous mixer, creating it on first use.
+
+        The always-on setting is applied on every call so changes made in the
+        settings panel take effect with the next sound.
+        """
+        always_on = config.conf["unspoken"]["alwaysOn"]
+        if self._mixer is None:
+            self._mixer = LoopbackMixer(
+                self.audio_engine,
+                self._mixer_feed,
+                self._mixer_idle,
+                always_on=always_on,
+                latency=self._latency,
+            )
+        elif self._mixer.always_on != always_on:
+            self._mixer.set_always_on(always_on)
+        return self._mixer
+
+    def _mixer_feed(self, data, size):
+        with self._wave_player_lock:
+            self.wave_player.feed(data, size=size)
+
+    def _mixer_idle(self):
+        with self._wave_player_lock:
+            self.wave_player.idle()
+
+    def _play_sound_async(
+        self, role, angle_x, angle_y, distance, volume, generation, priority, interrupt=True, trace=None
+    ):
+        """Render sound on the render worker and hand it to the playback worker.
 
         Args:
                 role: Control type role constant
                 angle_x: Horizontal angle in degrees (-90 to 90)
                 angle_y: Vertical angle in degrees (-90 to 90)
+                distance: Source distance (1.0 unless sizeAsDistance places it farther)
                 volume: Pre-computed volume multiplier
                 generation: Sound generation number for interrupt detection
+                priority: PRIORITY_* class the sound was submitted in
+                interrupt: Whether a mixed sound stops the sounds already playing
+                trace: LatencyTrace for this sound, or None
         """
+        if trace is None:
+            trace = LatencyTrace()
+        trace.mark("started")
         if role not in sounds:
             return
+        # Dropped before it can wait for the render lock
+        if self._stale(generation, priority):
+            return
 
-        sound_data = sounds[role]
-        audio_data = sound_data["data"]
-
-        # Adjust volume (pre-computed on main thread)
-        adjusted_audio = [sample * volume for sample in audio_data]
+        sound_id = sounds[role]
 
-        # Process with OpenAL for HRTF spatialization and reverb
-        final_audio = self.audio_engine.process_sound(
-            adjusted_audio, angle_x, angle_y
-        )
-        if not final_audio:
-            log.warn("Failed processing %r", role)
+        if self._uses_mixer():
+            interrupt = interrupt or not config.conf["unspoken"]["mixSounds"]
+            if interrupt and self._yields(priority):
+                self._yielded += 1
+                return
+            # Started on the engine's voice pool; the mixer thread renders and
+            # feeds everything playing, so there is no per-sound stop()/feed().
+            # Without overlap every sound cuts off the previous one, though not
+            # the reverb tail it left behind.
+            self._get_mixer().play(
+                sound_id,
+                volume,
+                angle_x,
+                angle_y,
+                distance=distance,
+                interrupt=interrupt,
+                trace=trace,
+            )
+            seconds = self.audio_engine.sound_seconds(sound_id) or 0.0
+            self._playing = (generation, priority, time.perf_counter() + seconds)
+            return
+        if self._yields(priority):
+            self._yielded += 1
             return
+        if self._mixer is not None and self._mixer.always_on:
+            self._mixer.set_always_on(False)
+
+        if config.conf["unspoken"]["streamRender"]:
+            # Chunks are rendered lazily as the playback worker feeds them, so
+            # playback starts after one frame_size block instead of the whole tail.
+            chunks = self.audio_engine.stream_earcon(
+                sound_id, angle_x, angle_y, volume, distance
+            )
+        else:
+            # Spatialize with OpenAL (HRTF + reverb); volume is pre-computed on the
+            # main thread. Served from the engine's render cache when warm.
+            final_audio = self.audio_engine.render_earcon(
+                sound_id, angle_x, angle_y, volume, distance
+            )
+            if not final_audio:
+                log.warn("Failed processing %r", role)
+                return
+            self._mark_render(trace)
+            chunks = (final_audio,)
 
-        # Exit early if this sound has been superseded by a newer request
-        if generation != self._sound_generation:
+        # Exit early if this sound has been superseded by a newer request, or a
+        # more important sound started playing while it rendered
+        if self._stale(generation, priority):
+            return
+        if self._yields(priority):
+            self._yielded += 1
             return
 
         # Immediate interrupt - stop() is called WITHOUT lock to enable instant
-        # interruption per NVDA WavePlayer design. Any thread can interrupt at
-        # any time; the generation check above ensures only current sound stops.
+        # interruption per NVDA WavePlayer design. This unblocks a feed()/idle()
+        # of the previous sound on the playback worker; the generation check
+        # above ensures only current sound stops.
         self.wave_player.stop()
-
+        self._playing = (generation, priority, None)
+        self._playback_worker.submit((chunks, generation, priority, trace))
+
+    def _mark_render(self, trace):
+        """Mark the render as complete, with its context lock acquire if it took one."""
+        lock_times = last_lock_acquired()
+        if lock_times is not None and lock_times[0] >= trace.marks["started"]:
+            # Not taken on a render cache hit
+            trace.mark("waiting", lock_times[0])
+            trace.mark("locked", lock_times[1])
+        trace.mark("rendered")
+
+    def _playback_request(self, request):
+        chunks, generation, priority, trace = request
         # Lock protects feed() from concurrent calls (WavePlayer requirement).
-        # Second generation check catches threads that passed the pre-stop check
-        # but queued at the lock while a newer sound was requested.
-        with self._wave_player_lock:
-            if generation != self._sound_generation:
-                return
-            self.wave_player.feed(final_audio)
-            self.wave_player.idle()
+        # Generation checks catch sounds that were handed over but superseded by a
+        # newer request while waiting for the playback worker or between chunks.
+        try:
+            with self._wave_player_lock:
+                for chunk in chunks:
+                    if self._stale(generation, priority):
+                        return
+                    if "rendered" not in trace.marks:
+                        # Streaming: the first chunk was rendered on this thread
+                        self._mark_render(trace)
+                    self.wave_player.feed(chunk)
+                    if "fed" not in trace.marks:
+                        trace.mark("fed")
+                        self._latency.record(trace)
+                if self._stale(generation, priority):
+                    return
+                self.wave_player.idle()
+        finally:
+            playing = self._playing
+            if playing is not None and playing[0] == generation:
+                self._playing = None
+            # Release the engine's source if a stream was abandoned part way
+            close = getattr(chunks, "close", None)
+            if close is not None:
+                close()
+
+    @script(
+        description="Logs Unspoken sound latency percentiles, dropped sounds and memory use to the NVDA log",
+        gesture="kb:NVDA+control+shift+u",
+    )
+    def script_reportLatency(self, gesture):
+        self._latency.log_report()
+        log.info(
+            f"Unspoken render queue: {self._render_worker.submitted} sounds submitted, "
+            f"{self._render_worker.coalesced} dropped while waiting, "
+            f"{self._yielded} yielded to more important sounds"
+        )
+        if self._extract_times.recorded:
+            log.info(self._extract_times.format_report())
+        if self.audio_engine is not None:
+            log.info(format_memory_report(self.audio_engine.memory_report(), working_set_bytes()))
+
+    def diagnostics_report(self):
+        """Multi-line snapshot of the engine counters, for the diagnostics dialog."""
+        worker = self._render_worker
+        lines = [
+            f"Sounds requested: {worker.submitted}",
+            f"Sounds dropped: {self._dropped_stale} superseded by newer sounds, "
+            f"{worker.coalesced} replaced while waiting, "
+            f"{self._yielded} yielded to more important sounds",
+        ]
+        engine = self.audio_engine
+        if engine is not None:
+            cache = engine.render_cache.get_stats()
+            avoided = f"Renders avoided by the cache: {cache['hits']} of {cache['hits'] + cache['misses']} " \
+                f"({cache['hit_rate'] * 100.0:.0f}%)"
+            if engine.disk_cache is not None:
+                avoided += f", {engine.disk_cache.get_stats()['hits']} of them loaded from disk"
+            lines.append(avoided)
+        stats = self._latency.get_stats()
+        for stage, label in (("render", "Render time"), ("mutex", "Render lock wait"), ("total", "Event to sound")):
+            entry = stats.get(stage)
+            if entry is None:
+                lines.append(f"{label}: nothing recorded")
+            else:
+                lines.append(
+                    f"{label}: average {entry['mean']:.2f} ms, p95 {entry['p95']:.2f} ms, "
+                    f"peak {entry['max']:.2f} ms ({entry['count']} sounds)"
+                )
+        extraction = self._extract_times.get_stats()
+        if extraction is not None:
+            lines.append(
+                f"Main thread extraction: average {extraction['mean']:.2f} ms, "
+                f"peak {extraction['max']:.2f} ms ({extraction['count']} events)"
+            )
+        # nvwave reports no underruns of its own
+        underruns = []
+        if isinstance(self.wave_player, DeviceOutput):
+            underruns.append(f"direct output ran dry {self.wave_player.underruns} times")
+        if self._mixer is not None:
+            underruns.append(f"mixer fell behind {self._mixer.underruns} times")
+        lines.append("Output underruns: " + (", ".join(underruns) if underruns else "not measured on this path"))
+        if engine is not None:
+            lines.append(format_memory_report(engine.memory_report(), working_set_bytes()))
+            lines.append(
+                f"Engine: {engine.sample_rate} Hz, "
+                f"{'native spatializer' if engine.uses_native_spatializer else 'ctypes render path'}, "
+                f"{'direct output' if isinstance(self.wave_player, DeviceOutput) else 'NVDA audio output'}"
+            )
+        else:
+            lines.append("Engine: not loaded")
+        return "\n".join(lines)
 
     def event_gainFocus(self, obj, nextHandler):
         # Always call nextHandler first to avoid blocking navigation
         nextHandler()
-        self._play_object_async(obj)
+        self._play_throttled("focus", obj)
 
     def event_mouseMove(self, obj, nextHandler, x, y):
         # Always call nextHandler first
@@ -394,15 +852,37 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
 
         if obj != self._previous_mouse_object:
             self._previous_mouse_object = obj
-            self._play_object_async(obj)
+            self._play_throttled("mouse", obj)
 
     def terminate(self):
-        # Stop the timer
-        if hasattr(self, "_navigation_timer"):
-            self._navigation_timer.Stop()
+        for throttle in self._throttles.values():
+            throttle.cancel()
+        self._geometry.unwatch()
+
+        # The engine may still be loading; if it is stuck (in the audio driver),
+        # leave the engine to the init thread rather than hang NVDA
+        self._terminating = True
+        self._init_thread.join(INIT_JOIN_TIMEOUT)
+        engine_loaded = not self._init_thread.is_alive()
+        if not engine_loaded:
+            log.warning("Unspoken audio engine still loading at exit; not waiting for it")
+
+        # Stop audio workers; a new focus-class generation discards in-flight sounds
+        self._next_generation(PRIORITY_FOCUS)
+        if engine_loaded and self._prewarmer is not None:
+            self.audio_engine.remove_reverb_listener(self._restart_prewarm)
+            self._prewarmer.stop()
+        self._render_worker.stop()
+        self._playback_worker.stop()
+        if engine_loaded and self._mixer is not None:
+            self._mixer.stop()
+        if self._latency.recorded:
+            log.debug(self._latency.format_report())
 
         # Restore original hooks
         speech.speech.getPropertiesSpeech = self._NVDA_getSpeechTextForProperties
+        api.setNavigatorObject = self._NVDA_setNavigatorObject
+        api.setReviewPosition = self._NVDA_setReviewPosition
 
         # Close WavePlayer
         if hasattr(self, "wave_player"):
@@ -413,12 +893,27 @@ class GlobalPlugin(globalPluginHandler.GlobalPlugin):
                 pass
 
         # Cleanup OpenAL audio engine
-        if hasattr(self, "audio_engine"):
-            self.audio_engine.cleanup()
+        if engine_loaded:
+            self._release_engine(workers_stopped=True)
         synthChanged.unregister(self.on_synthChanged)
 
+    def _release_engine(self, workers_stopped=False):
+        """Stop the pre-warmer and mixer (unless already stopped) and clean up the audio engine."""
+        if not workers_stopped:
+            if self._prewarmer is not None:
+                self.audio_engine.remove_reverb_listener(self._restart_prewarm)
+                self._prewarmer.stop()
+            if self._mixer is not None:
+                self._mixer.stop()
+        if self.audio_engine is not None:
+            if self.audio_engine.disk_cache is not None:
+                self.audio_engine.disk_cache.close()
+            self.audio_engine.cleanup()
+
     def on_synthChanged(self):
         self._update_volume_cache()
+        # Cached renders are keyed by volume
+        self._restart_prewarm()
         with self._wave_player_lock:
             self.wave_player.close()
             self.create_wave_player()
@@ -1,9 +1,79 @@
 import wx
+import api
 import config
+import globalPluginHandler
 import gui
 from gui import settingsDialogs, guiHelper, NVDASettingsDialog
 
 
+def _running_plugin():
+	"""Return the running Unspoken GlobalPlugin, or None."""
+	from . import GlobalPlugin
+
+	for plugin in globalPluginHandler.runningPlugins:
+		if isinstance(plugin, GlobalPlugin):
+			return plugin
+	return None
+
+
+class DiagnosticsDialog(wx.Dialog):
+	"""Live engine counters, refreshed every second, with a copy to clipboard button."""
+
+	REFRESH_MS = 1000
+
+	def __init__(self, parent):
+		super().__init__(parent, title="Unspoken diagnostics")
+		mainSizer = wx.BoxSizer(wx.VERTICAL)
+		sizer = guiHelper.BoxSizerHelper(self, orientation=wx.VERTICAL)
+		self.reportText = sizer.addLabeledControl(
+			"&Counters",
+			wx.TextCtrl,
+			style=wx.TE_MULTILINE | wx.TE_READONLY | wx.TE_RICH2,
+			size=(600, 300),
+		)
+		buttons = guiHelper.ButtonHelper(wx.HORIZONTAL)
+		copyButton = buttons.addButton(self, label="C&opy to clipboard")
+		copyButton.Bind(wx.EVT_BUTTON, self.onCopy)
+		closeButton = buttons.addButton(self, id=wx.ID_CLOSE, label="&Close")
+		closeButton.Bind(wx.EVT_BUTTON, lambda event: self.Close())
+		sizer.addDialogDismissButtons(buttons)
+		mainSizer.Add(sizer.sizer, border=guiHelper.BORDER_FOR_DIALOGS, flag=wx.ALL)
+		self.SetSizer(mainSizer)
+		mainSizer.Fit(self)
+		self.SetEscapeId(wx.ID_CLOSE)
+		self.Bind(wx.EVT_CLOSE, lambda event: self.Destroy())
+		# Also sent when the settings dialog that owns this one is closed
+		self.Bind(wx.EVT_WINDOW_DESTROY, self.onDestroy)
+		self.refresh()
+		self.timer = wx.Timer(self)
+		self.Bind(wx.EVT_TIMER, lambda event: self.refresh(), self.timer)
+		self.timer.Start(self.REFRESH_MS)
+		self.reportText.SetFocus()
+
+	def report(self):
+		plugin = _running_plugin()
+		if plugin is None:
+			return "Unspoken is not running"
+		return plugin.diagnostics_report()
+
+	def refresh(self):
+		text = self.report()
+		if text == self.reportText.GetValue():
+			return
+		# Keep the reading position of a screen reader user reviewing the text
+		position = self.reportText.GetInsertionPoint()
+		self.reportText.SetValue(text)
+		self.reportText.SetInsertionPoint(min(position, self.reportText.GetLastPosition()))
+
+	def onCopy(self, event):
+		api.copyToClip(self.report(), notify=True)
+
+	def onDestroy(self, event):
+		if event.GetEventObject() is self:
+			self.timer.Stop()
+		event.Skip()
+
+
 class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 	title = "Unspoken"
 
@@ -28,6 +98,11 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 		)
 		self.ReverbCheckBox.SetValue(config.conf["unspoken"]["Reverb"])
 		self.ReverbCheckBox.Bind(wx.EVT_CHECKBOX, self.onReverbSettingChanged)
+		self.classicReverbCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Use the c&lassic Unspoken reverb instead of OpenAL's (needs spatializer.dll)")
+		)
+		self.classicReverbCheckBox.SetValue(config.conf["unspoken"]["classicReverb"])
+		self.classicReverbCheckBox.Bind(wx.EVT_CHECKBOX, self.onReverbSettingChanged)
 
 		# EFX reverb settings
 		self.RoomSizeSliderLabel = settingsSizer.addItem(
@@ -89,6 +164,67 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 		)
 		self.WidthSlider.Bind(wx.EVT_SLIDER, self.onReverbSettingChanged)
 
+		self.TailFloorSliderLabel = settingsSizer.addItem(
+			wx.StaticText(self, label="Reverb tail cutoff in dB below full scale (30-96)")
+		)
+		self.TailFloorSlider = settingsSizer.addItem(
+			wx.Slider(
+				self,
+				value=config.conf["unspoken"]["TailFloor"],
+				minValue=30,
+				maxValue=96,
+			)
+		)
+		self.TailFloorSlider.Bind(wx.EVT_SLIDER, self.onReverbSettingChanged)
+
+		self.MouseIntervalSliderLabel = settingsSizer.addItem(
+			wx.StaticText(self, label="Minimum time between mouse sounds in ms (0-1000)")
+		)
+		self.MouseIntervalSlider = settingsSizer.addItem(
+			wx.Slider(
+				self,
+				value=config.conf["unspoken"]["MouseInterval"],
+				minValue=0,
+				maxValue=1000,
+			)
+		)
+		self.mouseSettleCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="&Wait for the mouse to stop before playing its sound")
+		)
+		self.mouseSettleCheckBox.SetValue(config.conf["unspoken"]["mouseSettle"])
+
+		self.NavigatorIntervalSliderLabel = settingsSizer.addItem(
+			wx.StaticText(self, label="Minimum time between navigator object sounds in ms (0-1000)")
+		)
+		self.NavigatorIntervalSlider = settingsSizer.addItem(
+			wx.Slider(
+				self,
+				value=config.conf["unspoken"]["NavigatorInterval"],
+				minValue=0,
+				maxValue=1000,
+			)
+		)
+		self.navigatorSettleCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Wait for the &navigator object to stop moving before playing its sound")
+		)
+		self.navigatorSettleCheckBox.SetValue(config.conf["unspoken"]["navigatorSettle"])
+
+		self.FocusIntervalSliderLabel = settingsSizer.addItem(
+			wx.StaticText(self, label="Minimum time between focus sounds in ms (0-1000)")
+		)
+		self.FocusIntervalSlider = settingsSizer.addItem(
+			wx.Slider(
+				self,
+				value=config.conf["unspoken"]["FocusInterval"],
+				minValue=0,
+				maxValue=1000,
+			)
+		)
+		self.focusSettleCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Wait for the &focus to stop moving before playing its sound")
+		)
+		self.focusSettleCheckBox.SetValue(config.conf["unspoken"]["focusSettle"])
+
 		self.noSoundsCheckBox = settingsSizer.addItem(
 			wx.CheckBox(self, label="&play sounds for roles (Enable Add-On)")
 		)
@@ -99,8 +235,47 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 			wx.CheckBox(self, label="Automatically adjust sounds with speech &volume")
 		)
 		self.volumeCheckBox.SetValue(config.conf["unspoken"]["volumeAdjust"])
+		self.sizeAsDistanceCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Place large objects, such as panes, farther &away")
+		)
+		self.sizeAsDistanceCheckBox.SetValue(config.conf["unspoken"]["sizeAsDistance"])
+		self.streamRenderCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="S&tart playing sounds before reverb has finished rendering")
+		)
+		self.streamRenderCheckBox.SetValue(config.conf["unspoken"]["streamRender"])
+		self.mixSoundsCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="&Overlap sounds instead of interrupting them")
+		)
+		self.mixSoundsCheckBox.SetValue(config.conf["unspoken"]["mixSounds"])
+		self.alwaysOnCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="&Keep the audio stream open between sounds")
+		)
+		self.alwaysOnCheckBox.SetValue(config.conf["unspoken"]["alwaysOn"])
+		self.sharedReverbCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Let reverb tails carry on und&er the next sound (one shared room)")
+		)
+		self.sharedReverbCheckBox.SetValue(config.conf["unspoken"]["sharedReverb"])
+		self.prewarmCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Prepare &common sounds in the background")
+		)
+		self.prewarmCheckBox.SetValue(config.conf["unspoken"]["prewarm"])
+		self.diskCacheCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="Keep prepared sounds on &disk between sessions (after restarting NVDA)")
+		)
+		self.diskCacheCheckBox.SetValue(config.conf["unspoken"]["diskCache"])
+		self.directOutputCheckBox = settingsSizer.addItem(
+			wx.CheckBox(self, label="&Bypass NVDA's audio output for lower latency (sounds are not ducked)")
+		)
+		self.directOutputCheckBox.SetValue(config.conf["unspoken"]["directOutput"])
+		self.diagnosticsButton = settingsSizer.addItem(
+			wx.Button(self, label="Show dia&gnostics...")
+		)
+		self.diagnosticsButton.Bind(wx.EVT_BUTTON, self.onShowDiagnostics)
 		self.unspoken_copy = config.conf["unspoken"].copy()
 
+	def onShowDiagnostics(self, event):
+		DiagnosticsDialog(self).Show()
+
 	def onReverbSettingChanged(self, event):
 		"""Push slider values to the live OpenALLoopback instance.
 		enable_reverb() is called before set_reverb_settings() so the EFX tail
@@ -113,6 +288,7 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 			if openal_audio_instance and openal_audio_instance.initialized:
 				config.conf["unspoken"]["Reverb"] = self.ReverbCheckBox.IsChecked()
 				openal_audio_instance.enable_reverb(self.ReverbCheckBox.IsChecked())
+				openal_audio_instance.use_classic_reverb(self.classicReverbCheckBox.IsChecked())
 				openal_audio_instance.set_reverb_settings(
 					room_size=self.RoomSizeSlider.GetValue() / 100.0,
 					damping=self.DampingSlider.GetValue() / 100.0,
@@ -120,6 +296,7 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 					dry_level=self.DryLevelSlider.GetValue() / 100.0,
 					width=self.WidthSlider.GetValue() / 100.0,
 				)
+				openal_audio_instance.set_tail_floor(-self.TailFloorSlider.GetValue())
 		except ImportError:
 			pass
 
@@ -141,6 +318,7 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 
 		config.conf["unspoken"]["HRTF"] = self.HRTFCheckBox.IsChecked()
 		config.conf["unspoken"]["Reverb"] = self.ReverbCheckBox.IsChecked()
+		config.conf["unspoken"]["classicReverb"] = self.classicReverbCheckBox.IsChecked()
 
 		# Save EFX reverb settings
 		config.conf["unspoken"]["RoomSize"] = self.RoomSizeSlider.GetValue()
@@ -148,8 +326,23 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 		config.conf["unspoken"]["WetLevel"] = self.WetLevelSlider.GetValue()
 		config.conf["unspoken"]["DryLevel"] = self.DryLevelSlider.GetValue()
 		config.conf["unspoken"]["Width"] = self.WidthSlider.GetValue()
+		config.conf["unspoken"]["TailFloor"] = self.TailFloorSlider.GetValue()
 		config.conf["unspoken"]["noSounds"] = not self.noSoundsCheckBox.IsChecked()
 		config.conf["unspoken"]["volumeAdjust"] = self.volumeCheckBox.IsChecked()
+		config.conf["unspoken"]["sizeAsDistance"] = self.sizeAsDistanceCheckBox.IsChecked()
+		config.conf["unspoken"]["streamRender"] = self.streamRenderCheckBox.IsChecked()
+		config.conf["unspoken"]["mixSounds"] = self.mixSoundsCheckBox.IsChecked()
+		config.conf["unspoken"]["alwaysOn"] = self.alwaysOnCheckBox.IsChecked()
+		config.conf["unspoken"]["sharedReverb"] = self.sharedReverbCheckBox.IsChecked()
+		config.conf["unspoken"]["prewarm"] = self.prewarmCheckBox.IsChecked()
+		config.conf["unspoken"]["diskCache"] = self.diskCacheCheckBox.IsChecked()
+		config.conf["unspoken"]["directOutput"] = self.directOutputCheckBox.IsChecked()
+		config.conf["unspoken"]["MouseInterval"] = self.MouseIntervalSlider.GetValue()
+		config.conf["unspoken"]["mouseSettle"] = self.mouseSettleCheckBox.IsChecked()
+		config.conf["unspoken"]["NavigatorInterval"] = self.NavigatorIntervalSlider.GetValue()
+		config.conf["unspoken"]["navigatorSettle"] = self.navigatorSettleCheckBox.IsChecked()
+		config.conf["unspoken"]["FocusInterval"] = self.FocusIntervalSlider.GetValue()
+		config.conf["unspoken"]["focusSettle"] = self.focusSettleCheckBox.IsChecked()
 
 	def update_reverb_from_config(self):
 		# Update OpenAL EFX reverb settings
@@ -159,6 +352,7 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 			openal_audio_instance = openal_audio.get_openal_audio()
 			if openal_audio_instance and openal_audio_instance.initialized:
 				openal_audio_instance.enable_reverb(config.conf["unspoken"]["Reverb"])
+				openal_audio_instance.use_classic_reverb(config.conf["unspoken"]["classicReverb"])
 				openal_audio_instance.set_reverb_settings(
 					room_size=config.conf["unspoken"]["RoomSize"] / 100.0,
 					damping=config.conf["unspoken"]["Damping"] / 100.0,
@@ -166,6 +360,7 @@ class SettingsPanel(gui.settingsDialogs.SettingsPanel):
 					dry_level=config.conf["unspoken"]["DryLevel"] / 100.0,
 					width=config.conf["unspoken"]["Width"] / 100.0,
 				)
+				openal_audio_instance.set_tail_floor(-config.conf["unspoken"]["TailFloor"])
 		except ImportError:
 			pass
 
@@ -0,0 +1,105 @@
+"""
+Long-lived audio worker with a latest-wins mailbox.
+
+Replaces one threading.Thread per sound. Requests are posted from NVDA's main
+thread with submit(); the mailbox holds at most one pending request, so a burst
+of events collapses to the newest one before any rendering starts. Requests the
+worker never picked up are counted as coalesced.
+
+The mailbox can be split into priority classes (0 is the most important), each
+holding up to its own depth of requests. The worker always takes the oldest
+request of the most important class that has any, and a request of one class
+drops whatever is still waiting in less important ones, so under load
+low-priority work is discarded instead of queueing for the render lock. The
+render worker uses the PRIORITY_* classes below.
+
+The add-on runs two of these: a render worker and a playback worker. Keeping
+playback on its own thread preserves the old interrupt behaviour -- the render
+worker calls WavePlayer.stop() as soon as a newer sound is ready, which unblocks
+a feed()/idle() still playing the previous sound on the playback worker.
+
+Workers only order and drop work: stale-result checks (GlobalPlugin._superseded)
+still happen in the handlers, exactly as with per-sound threads.
+"""
+
+import threading
+from collections import deque
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+# Render worker priority classes, most important first
+PRIORITY_FOCUS = 0
+PRIORITY_NAVIGATOR = 1
+PRIORITY_MOUSE = 2
+# Requests each class may hold waiting. Only the newest of a class is ever
+# heard: the render handler drops a request once its class has a newer one
+# (GlobalPlugin._stale), so a deeper class would only hold doomed requests.
+PRIORITY_DEPTHS = (1, 1, 1)
+
+
+class AudioWorker:
+    """Single daemon thread that runs handler(request) for the newest submitted requests.
+
+    depths gives the number of priority classes and how many requests each may
+    hold waiting; the default is one class of depth one (latest wins).
+    """
+
+    def __init__(self, handler, name="UnspokenAudioWorker", depths=(1,)):
+        self._handler = handler
+        self._cond = threading.Condition()
+        self._pending = [deque(maxlen=depth) for depth in depths]
+        self._running = True
+        self.submitted = 0
+        self.coalesced = 0
+        self._thread = threading.Thread(target=self._run, name=name, daemon=True)
+        self._thread.start()
+
+    def submit(self, request, priority=0):
+        """Post request in a priority class, dropping the oldest of that class if it is full.
+
+        Requests still waiting in less important classes are dropped too.
+        """
+        with self._cond:
+            queue = self._pending[priority]
+            if len(queue) == queue.maxlen:
+                self.coalesced += 1
+            queue.append(request)
+            for lower in self._pending[priority + 1:]:
+                self.coalesced += len(lower)
+                lower.clear()
+            self.submitted += 1
+            self._cond.notify()
+
+    def stop(self, timeout=1.0):
+        """Discard pending work and join the worker thread."""
+        with self._cond:
+            self._running = False
+            for queue in self._pending:
+                queue.clear()
+            self._cond.notify()
+        if self._thread is not threading.current_thread():
+            self._thread.join(timeout)
+
+    def _next_request(self):
+        """Pop the oldest request of the most important non-empty class, or None. Caller holds _cond."""
+        for queue in self._pending:
+            if queue:
+                return queue.popleft()
+        return None
+
+    def _run(self):
+        while True:
+            with self._cond:
+                request = self._next_request()
+                while request is None and self._running:
+                    self._cond.wait()
+                    request = self._next_request()
+                if not self._running:
+                    return
+            try:
+                self._handler(request)
+            except Exception:
+                log.error("Unspoken audio worker request failed", exc_info=True)
@@ -0,0 +1,304 @@
+"""
+Direct-to-device output through an OpenAL Soft playback device.
+
+An optional replacement for the add-on's nvwave.WavePlayer. Rendered stereo
+PCM is queued on a source of a real OpenAL Soft playback device (WASAPI on
+Windows) in period_frames blocks, with the device mixing period set to the
+same size, so a block reaches the speakers a few milliseconds after it is
+fed instead of after the WavePlayer's buffering. NVDA's audio ducking does not
+apply to this output.
+
+DeviceOutput has the subset of the WavePlayer interface the add-on uses:
+feed() blocks while queue_blocks blocks are waiting, idle() blocks until
+everything fed has played, stop() may be called from any thread and drops
+whatever is queued, and close() releases the device.
+
+The loopback contexts that render the sounds are current per thread, so this
+needs ALC_EXT_thread_local_context; every AL call here makes the playback
+context current on the calling thread first, like OpenALLoopback._enter.
+"""
+
+import ctypes
+import threading
+import time
+
+from .openal_audio import (
+    ALC_FREQUENCY,
+    ALC_HRTF_SOFT,
+    AL_BUFFER,
+    AL_BUFFERS_PROCESSED,
+    AL_BUFFERS_QUEUED,
+    AL_DIRECT_CHANNELS_SOFT,
+    AL_FORMAT_STEREO16,
+    AL_PLAYING,
+    AL_SOURCE_STATE,
+)
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+ALC_REFRESH = 0x1008
+ALC_DEVICE_SPECIFIER = 0x1005
+ALC_ALL_DEVICES_SPECIFIER = 0x1013
+
+# 256 frames is ~5.8 ms at 44.1 kHz
+DEFAULT_PERIOD_FRAMES = 256
+DEFAULT_QUEUE_BLOCKS = 3
+
+# NVDA's names for "follow the Windows default device"
+_DEFAULT_DEVICE_NAMES = ("", "default", "Microsoft Sound Mapper")
+
+# Stereo 16-bit
+_BYTES_PER_FRAME = 4
+
+
+def _device_names(dll):
+    """Names of OpenAL Soft's playback devices, or [] if they cannot be listed."""
+    if dll.alcIsExtensionPresent(None, b"ALC_ENUMERATE_ALL_EXT"):
+        spec = ALC_ALL_DEVICES_SPECIFIER
+    else:
+        spec = ALC_DEVICE_SPECIFIER
+    address = dll.alcGetString(None, spec)
+    names = []
+    # A list of NUL-terminated strings ended by an empty one
+    while address:
+        name = ctypes.string_at(address)
+        if not name:
+            break
+        names.append(name.decode("utf-8", "replace"))
+        address += len(name) + 1
+    return names
+
+
+def find_device(dll, output_device):
+    """Return the OpenAL device name for NVDA's outputDevice setting, or None for the default.
+
+    OpenAL Soft's WASAPI backend names devices "OpenAL Soft on <name>", where
+    <name> is the Windows friendly name NVDA shows.
+    """
+    if not output_device or output_device in _DEFAULT_DEVICE_NAMES:
+        return None
+    names = _device_names(dll)
+    for name in names:
+        if name == output_device or name.endswith(" on " + output_device):
+            return name
+    for name in names:
+        if output_device in name:
+            return name
+    log.debug(f"No OpenAL device matches output device {output_device!r}; using the default device")
+    return None
+
+
+def device_mix_rate(dll, output_device):
+    """Return the mix rate of NVDA's output device, or None if it cannot be read.
+
+    OpenAL Soft opens a playback device at the rate of the Windows mix format when
+    no ALC_FREQUENCY is requested, so a context is created briefly and the rate
+    read back from it.
+    """
+    name = find_device(dll, output_device)
+    device = dll.alcOpenDevice(name.encode("utf-8") if name else None)
+    if not device:
+        log.debug(f"alcOpenDevice failed for {name or 'the default device'}; mix rate unknown")
+        return None
+    try:
+        context = dll.alcCreateContext(device, None)
+        if not context:
+            return None
+        rate = ctypes.c_int(0)
+        dll.alcGetIntegerv(device, ALC_FREQUENCY, 1, ctypes.byref(rate))
+        dll.alcDestroyContext(context)
+        return rate.value if rate.value > 0 else None
+    finally:
+        dll.alcCloseDevice(device)
+
+
+def _buffer_address(data):
+    """Address of the bytes in data (bytes or a writable buffer such as a ctypes array)."""
+    if isinstance(data, bytes):
+        return ctypes.cast(ctypes.c_char_p(data), ctypes.c_void_p).value
+    return ctypes.addressof(ctypes.c_char.from_buffer(data))
+
+
+class DeviceOutput:
+    """Stereo 16-bit PCM stream on an OpenAL Soft playback device."""
+
+    @classmethod
+    def open(cls, engine, output_device, period_frames=DEFAULT_PERIOD_FRAMES, queue_blocks=DEFAULT_QUEUE_BLOCKS):
+        """Open a playback device for engine's output format.
+
+        Returns a DeviceOutput, or None if the device cannot be opened (the caller
+        falls back to nvwave.WavePlayer).
+        """
+        if engine.dll is None or not engine.initialized:
+            return None
+        if engine._alcSetThreadContext is None:
+            log.warning("Direct device output needs ALC_EXT_thread_local_context; using nvwave")
+            return None
+        output = cls(engine.dll, engine._alcSetThreadContext, engine.sample_rate, period_frames, queue_blocks)
+        try:
+            ok = output._open(find_device(engine.dll, output_device))
+        except Exception:
+            log.error("Failed opening direct device output", exc_info=True)
+            ok = False
+        if not ok:
+            output.close()
+            return None
+        return output
+
+    def __init__(self, dll, set_thread_context, sample_rate, period_frames, queue_blocks):
+        self._dll = dll
+        self._set_thread_context = set_thread_context
+        self.sample_rate = sample_rate
+        self.period_frames = period_frames
+        self.queue_blocks = queue_blocks
+        self._block_bytes = period_frames * _BYTES_PER_FRAME
+        self._block_seconds = period_frames / float(sample_rate)
+        # Held only around AL calls, never while waiting, so stop() is immediate
+        self._lock = threading.Lock()
+        self._device = None
+        self._context = None
+        self._source = ctypes.c_uint(0)
+        self._buffers = (ctypes.c_uint * queue_blocks)()
+        self._free = []
+        # Incremented by stop(); a feed() or idle() in progress returns when it changes
+        self._stops = 0
+        # True from the first block fed until idle() or stop() ends the stream
+        self._streaming = False
+        # Times the queue ran dry in the middle of a stream
+        self.underruns = 0
+        self.device_name = None
+
+    def _open(self, device_name):
+        dll = self._dll
+        self._device = dll.alcOpenDevice(device_name.encode("utf-8") if device_name else None)
+        if not self._device:
+            log.error(f"alcOpenDevice failed for {device_name or 'the default device'}")
+            return False
+        # Sounds arrive already spatialized: no HRTF, and a mixing period of one block
+        attrs = (ctypes.c_int * 7)(
+            ALC_FREQUENCY, self.sample_rate,
+            ALC_REFRESH, max(1, self.sample_rate // self.period_frames),
+            ALC_HRTF_SOFT, 0,
+            0,
+        )
+        self._context = dll.alcCreateContext(self._device, attrs)
+        if not self._context:
+            log.error("alcCreateContext failed for direct device output")
+            return False
+        with self._lock:
+            self._set_thread_context(self._context)
+            dll.alGenSources(1, ctypes.byref(self._source))
+            # Stereo buffers would otherwise be virtualized onto two speakers
+            dll.alSourcei(self._source.value, AL_DIRECT_CHANNELS_SOFT, 1)
+            dll.alGenBuffers(self.queue_blocks, self._buffers)
+            if dll.alGetError() != 0:
+                log.error("Failed creating direct device output source")
+                return False
+            self._free = list(self._buffers)
+        self.device_name = device_name
+        log.debug(f"Direct device output on {device_name or 'the default device'}: "
+                  f"{self.period_frames} frame periods at {self.sample_rate} Hz")
+        return True
+
+    def _reclaim(self):
+        """Unqueue played buffers; return (queued count, playing). Caller holds _lock."""
+        dll = self._dll
+        source = self._source.value
+        processed = ctypes.c_int(0)
+        dll.alGetSourcei(source, AL_BUFFERS_PROCESSED, ctypes.byref(processed))
+        if processed.value > 0:
+            done = (ctypes.c_uint * processed.value)()
+            dll.alSourceUnqueueBuffers(source, processed.value, done)
+            self._free.extend(done)
+        queued = ctypes.c_int(0)
+        state = ctypes.c_int(0)
+        dll.alGetSourcei(source, AL_BUFFERS_QUEUED, ctypes.byref(queued))
+        dll.alGetSourcei(source, AL_SOURCE_STATE, ctypes.byref(state))
+        return queued.value, state.value == AL_PLAYING
+
+    def feed(self, data, size=None):
+        """Queue PCM, blocking while the queue is full. Returns early after stop().
+
+        data is bytes, or a c_void_p with size as nvwave.WavePlayer.feed() takes it.
+        Each period is uploaded straight from data; alBufferData copies it, so data
+        may be reused once feed() returns.
+        """
+        stops = self._stops
+        if isinstance(data, ctypes.c_void_p):
+            address = data.value
+        else:
+            # data stays referenced here for as long as its address is in use
+            address = _buffer_address(data)
+            if size is None:
+                size = memoryview(data).nbytes
+        dll = self._dll
+        for offset in range(0, size, self._block_bytes):
+            length = min(self._block_bytes, size - offset)
+            while True:
+                if stops != self._stops:
+                    return
+                with self._lock:
+                    if self._context is None:
+                        return
+                    self._set_thread_context(self._context)
+                    queued, playing = self._reclaim()
+                    if self._free:
+                        buffer = self._free.pop()
+                        dll.alBufferData(buffer, AL_FORMAT_STEREO16, address + offset, length, self.sample_rate)
+                        dll.alSourceQueueBuffers(self._source.value, 1, ctypes.byref(ctypes.c_uint(buffer)))
+                        if not playing:
+                            # First block, or the queue ran dry (underrun)
+                            if self._streaming:
+                                self.underruns += 1
+                            self._streaming = True
+                            dll.alSourcePlay(self._source.value)
+                        break
+                time.sleep(self._block_seconds / 2.0)
+
+    def idle(self):
+        """Block until everything fed has played, or stop() is called."""
+        stops = self._stops
+        while stops == self._stops:
+            with self._lock:
+                if self._context is None:
+                    return
+                self._set_thread_context(self._context)
+                queued, playing = self._reclaim()
+            if not queued or not playing:
+                self._streaming = False
+                return
+            time.sleep(self._block_seconds / 2.0)
+
+    def stop(self):
+        """Drop everything queued; safe to call from any thread."""
+        self._stops += 1
+        self._streaming = False
+        with self._lock:
+            if self._context is None:
+                return
+            self._set_thread_context(self._context)
+            # Stopping marks every queued buffer processed
+            self._dll.alSourceStop(self._source.value)
+            self._reclaim()
+
+    def close(self):
+        self._stops += 1
+        dll = self._dll
+        with self._lock:
+            if self._context is not None:
+                self._set_thread_context(self._context)
+                if self._source.value:
+                    dll.alSourceStop(self._source.value)
+                    dll.alSourcei(self._source.value, AL_BUFFER, 0)
+                    dll.alDeleteSources(1, ctypes.byref(self._source))
+                    self._source = ctypes.c_uint(0)
+                dll.alDeleteBuffers(self.queue_blocks, self._buffers)
+                self._set_thread_context(None)
+                dll.alcDestroyContext(self._context)
+                self._context = None
+            if self._device:
+                dll.alcCloseDevice(self._device)
+                self._device = None
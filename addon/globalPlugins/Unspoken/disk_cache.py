@@ -0,0 +1,224 @@
+"""
+Persistent on-disk render cache that survives NVDA restarts.
+
+A second level behind RenderCache: a render cache miss is looked up here
+before rendering, and every finished render is appended here as well. Nothing
+happens at construction; the file is opened, memory-mapped and indexed on the
+first lookup (on the render worker), so NVDA startup does not read it.
+
+File layout (little endian):
+
+    b"UNSPKRC1"  u32 header length  header JSON (format version, fingerprint)
+    records:     u32 key length  u32 PCM length  key (UTF-8)  PCM
+
+Keys are built by OpenALLoopback.disk_key from the sound file content hash,
+the quantized angles, the volume and a hash of the reverb key. The fingerprint
+covers the OpenAL Soft DLL and any HRTF data sets next to it (size and mtime)
+and the output sample rate; if it does not match, the whole file is discarded.
+Records left torn by a crash are cut off when the file is opened. Once the
+file exceeds max_bytes it is discarded and starts over; renders under older
+settings simply stop being looked up.
+
+Appends are done on a writer thread so a render never waits for disk I/O.
+"""
+
+import json
+import mmap
+import os
+import queue
+import struct
+import threading
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+MAGIC = b"UNSPKRC1"
+FORMAT_VERSION = 1
+DEFAULT_MAX_BYTES = 64 * 1024 * 1024
+
+_U32 = struct.Struct("<I")
+_RECORD = struct.Struct("<II")
+
+
+def file_fingerprint(paths):
+    """Return [name, size, mtime_ns] for each existing path; changes when any file is replaced."""
+    fingerprint = []
+    for path in paths:
+        try:
+            st = os.stat(path)
+        except OSError:
+            continue
+        fingerprint.append([os.path.basename(path), st.st_size, st.st_mtime_ns])
+    return fingerprint
+
+
+class DiskRenderCache:
+    """Memory-mapped append-only store of rendered PCM keyed by strings."""
+
+    def __init__(self, path, fingerprint, max_bytes=DEFAULT_MAX_BYTES):
+        self.path = path
+        self._header = json.dumps(
+            {"version": FORMAT_VERSION, "fingerprint": fingerprint}, sort_keys=True
+        ).encode("utf-8")
+        self.max_bytes = max_bytes
+        self._lock = threading.Lock()
+        self._opened = False
+        self._failed = False
+        self._map = None
+        # key -> (PCM offset, PCM length)
+        self._index = {}
+        self._size = 0
+        self._queue = None
+        self._writer = None
+        self.hits = 0
+        self.misses = 0
+
+    def get(self, key):
+        """Return cached PCM bytes for key, or None."""
+        with self._lock:
+            if not self._ensure_open():
+                return None
+            entry = self._index.get(key)
+            if entry is None:
+                self.misses += 1
+                return None
+            offset, length = entry
+            if self._map is None or offset + length > len(self._map):
+                self._remap()
+            if self._map is None:
+                return None
+            self.hits += 1
+            return self._map[offset:offset + length]
+
+    def put(self, key, pcm):
+        """Queue pcm to be appended under key; returns immediately."""
+        with self._lock:
+            if not self._ensure_open() or key in self._index:
+                return
+            if self._writer is None:
+                self._queue = queue.SimpleQueue()
+                self._writer = threading.Thread(target=self._write_loop, name="UnspokenDiskCache", daemon=True)
+                self._writer.start()
+        self._queue.put((key, bytes(pcm)))
+
+    def close(self):
+        """Flush pending writes and release the mapping."""
+        if self._writer is not None:
+            self._queue.put(None)
+            self._writer.join(2.0)
+            self._writer = None
+        with self._lock:
+            self._unmap()
+
+    def get_stats(self):
+        with self._lock:
+            return {
+                "entries": len(self._index),
+                "bytes": self._size,
+                "max_bytes": self.max_bytes,
+                "hits": self.hits,
+                "misses": self.misses,
+            }
+
+    def _ensure_open(self):
+        """Open and index the file on first use. Caller holds self._lock."""
+        if self._opened:
+            return not self._failed
+        self._opened = True
+        try:
+            self._load()
+        except OSError as e:
+            log.warning(f"Unspoken disk render cache unavailable: {self.path} -- {e}")
+            self._failed = True
+            self._unmap()
+        return not self._failed
+
+    def _load(self):
+        prefix = len(MAGIC) + _U32.size
+        if os.path.exists(self.path):
+            with open(self.path, "rb") as f:
+                head = f.read(prefix + len(self._header))
+            if (
+                head[:len(MAGIC)] == MAGIC
+                and _U32.unpack_from(head, len(MAGIC))[0] == len(self._header)
+                and head[prefix:] == self._header
+            ):
+                self._remap()
+                self._scan(prefix + len(self._header))
+                log.debug(f"Unspoken disk render cache: {len(self._index)} entries, {self._size} bytes")
+                return
+            log.debug("Unspoken disk render cache is stale or invalid; starting over")
+        self._reset()
+
+    def _scan(self, offset):
+        """Index records from offset, cutting off a torn record at the end."""
+        data = self._map
+        end = len(data) if data is not None else offset
+        while offset + _RECORD.size <= end:
+            key_len, pcm_len = _RECORD.unpack_from(data, offset)
+            pcm_offset = offset + _RECORD.size + key_len
+            if pcm_offset + pcm_len > end:
+                break
+            key = bytes(data[offset + _RECORD.size:pcm_offset]).decode("utf-8", "replace")
+            self._index[key] = (pcm_offset, pcm_len)
+            offset = pcm_offset + pcm_len
+        self._size = offset
+        if offset < end:
+            self._unmap()
+            with open(self.path, "r+b") as f:
+                f.truncate(offset)
+            self._remap()
+
+    def _reset(self):
+        """Replace the file with an empty one carrying the current header."""
+        self._unmap()
+        self._index.clear()
+        directory = os.path.dirname(self.path)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        with open(self.path, "wb") as f:
+            f.write(MAGIC)
+            f.write(_U32.pack(len(self._header)))
+            f.write(self._header)
+        self._size = len(MAGIC) + _U32.size + len(self._header)
+
+    def _remap(self):
+        """Map the whole file as it is now. Caller holds self._lock."""
+        self._unmap()
+        with open(self.path, "rb") as f:
+            if os.fstat(f.fileno()).st_size:
+                self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    def _unmap(self):
+        if self._map is not None:
+            self._map.close()
+            self._map = None
+
+    def _write_loop(self):
+        while True:
+            item = self._queue.get()
+            if item is None:
+                return
+            key, pcm = item
+            try:
+                self._append(key, pcm)
+            except OSError as e:
+                log.warning(f"Unspoken disk render cache write failed: {e}")
+
+    def _append(self, key, pcm):
+        encoded = key.encode("utf-8")
+        with self._lock:
+            if self._failed or key in self._index:
+                return
+            if self._size + _RECORD.size + len(encoded) + len(pcm) > self.max_bytes:
+                log.debug("Unspoken disk render cache full; starting over")
+                self._reset()
+            with open(self.path, "ab") as f:
+                f.write(_RECORD.pack(len(encoded), len(pcm)))
+                f.write(encoded)
+                f.write(pcm)
+            pcm_offset = self._size + _RECORD.size + len(encoded)
+            self._index[key] = (pcm_offset, len(pcm))
+            self._size = pcm_offset + len(pcm)
@@ -0,0 +1,85 @@
+"""
+Monitor geometry of the virtual desktop, for the spatial mapping.
+
+Every monitor's rectangle is read once on NVDA's main thread, and again only
+when Windows reports a display change (WM_DISPLAYCHANGE, which wx delivers to
+NVDA's main frame as EVT_DISPLAY_CHANGED): a resolution change, a monitor
+plugged in or removed, or monitors rearranged. Events never query the desktop.
+Monitors left of or above the primary one have negative origins; ScreenMap
+(spatial.py) maps across all of them.
+"""
+
+import wx
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+
+def read_monitors():
+    """Return every monitor's (left, top, width, height) in virtual desktop pixels, primary first."""
+    monitors = []
+    for index in range(wx.Display.GetCount()):
+        display = wx.Display(index)
+        rect = display.GetGeometry()
+        if rect.width <= 0 or rect.height <= 0:
+            continue
+        entry = (rect.x, rect.y, rect.width, rect.height)
+        if display.IsPrimary():
+            monitors.insert(0, entry)
+        else:
+            monitors.append(entry)
+    return monitors
+
+
+class DesktopGeometry:
+    """Cached monitor rectangles, with listeners called when they change.
+
+    fallback() returns one (left, top, width, height) rectangle for the whole
+    desktop; it is used if the monitors cannot be enumerated. All methods run on
+    NVDA's main thread.
+    """
+
+    def __init__(self, fallback=None):
+        self.monitors = ()
+        self._fallback = fallback
+        self._listeners = []
+        self._frame = None
+
+    def add_listener(self, listener):
+        """Register listener(monitors) to be called after the monitor layout changes."""
+        self._listeners.append(listener)
+
+    def refresh(self):
+        """Re-read the monitor layout, notifying listeners if it changed."""
+        try:
+            monitors = read_monitors()
+        except Exception:
+            log.debugWarning("Unspoken could not enumerate monitors", exc_info=True)
+            monitors = []
+        if not monitors and self._fallback is not None:
+            monitors = [tuple(self._fallback())]
+        monitors = tuple(monitors)
+        if not monitors or monitors == self.monitors:
+            return
+        self.monitors = monitors
+        log.debug(f"Unspoken monitor layout: {monitors}")
+        for listener in self._listeners:
+            listener(monitors)
+
+    def watch(self, frame):
+        """Refresh whenever frame, a top-level wx window, receives a display change."""
+        self.unwatch()
+        frame.Bind(wx.EVT_DISPLAY_CHANGED, self._on_display_changed)
+        self._frame = frame
+
+    def unwatch(self):
+        if self._frame is not None:
+            self._frame.Unbind(wx.EVT_DISPLAY_CHANGED, handler=self._on_display_changed)
+            self._frame = None
+
+    def _on_display_changed(self, event):
+        event.Skip()
+        # wx refreshes its own display list while handling the same message
+        wx.CallAfter(self.refresh)
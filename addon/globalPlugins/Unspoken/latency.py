@@ -0,0 +1,203 @@
+"""
+Latency instrumentation from NVDA event to first fed block.
+
+Each sound carries a LatencyTrace of time.perf_counter() marks taken along the
+hot path:
+
+    event      the NVDA event handler was entered
+    extracted  _extract_sound_params returned (main thread)
+    started    the render worker picked the request up
+    waiting    the render began acquiring a context lock (absent on a render
+               cache hit)
+    locked     that acquire returned
+    rendered   the first PCM is available (whole render, first stream chunk,
+               or voice started in mixing mode)
+    fed        the first WavePlayer.feed() returned
+
+nvwave.WavePlayer has no playback-started notification; the first feed()
+return is when the block has been queued on the device, and is used as the
+start of playback.
+
+LatencyStats turns finished traces into per-stage durations and keeps a
+rolling window of each for p50/p95/p99 reporting. Superseded sounds never
+reach "fed" and are not recorded. DurationStats keeps one such window for a
+single measurement, such as the main-thread time of every event including
+those that play no sound.
+"""
+
+import threading
+import time
+from collections import deque
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+# (stage name, start mark, end mark). Stages whose marks are missing are skipped.
+STAGES = (
+    ("extract", "event", "extracted"),
+    ("queue", "extracted", "started"),
+    ("mutex", "waiting", "locked"),
+    ("render", "started", "rendered"),
+    ("feed", "rendered", "fed"),
+    ("total", "event", "fed"),
+)
+
+DEFAULT_WINDOW = 1000
+
+PERCENTILES = (50, 95, 99)
+
+
+# Per-thread times of the last successful TimedLock acquire, shared by all
+# TimedLocks so a trace sees the render lock whichever loopback context the
+# render ran on.
+_lock_times = threading.local()
+
+
+def last_lock_acquired():
+    """(attempted, acquired) perf_counter() times of the calling thread's last
+    successful TimedLock acquire, or None."""
+    return getattr(_lock_times, "last", None)
+
+
+class TimedLock:
+    """threading.Lock that records when the calling thread started and finished
+    acquiring it (see last_lock_acquired)."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+
+    def acquire(self, blocking=True, timeout=-1):
+        attempted = time.perf_counter()
+        acquired = self._lock.acquire(blocking, timeout)
+        if acquired:
+            _lock_times.last = (attempted, time.perf_counter())
+        return acquired
+
+    def release(self):
+        self._lock.release()
+
+    def locked(self):
+        return self._lock.locked()
+
+    __enter__ = acquire
+
+    def __exit__(self, *exc):
+        self._lock.release()
+
+
+class LatencyTrace:
+    """Timestamps for one sound, keyed by mark name."""
+
+    __slots__ = ("marks",)
+
+    def __init__(self, event_time=None):
+        self.marks = {"event": time.perf_counter() if event_time is None else event_time}
+
+    def mark(self, name, when=None):
+        """Record name at when (default now), keeping the first time it was reached."""
+        if name not in self.marks:
+            self.marks[name] = time.perf_counter() if when is None else when
+
+
+def percentile(sorted_values, pct):
+    """Nearest-rank percentile of an already sorted, non-empty sequence."""
+    rank = max(1, -(-len(sorted_values) * pct // 100))
+    return sorted_values[int(rank) - 1]
+
+
+class LatencyStats:
+    """Rolling per-stage latency windows, safe to record into from any thread."""
+
+    def __init__(self, window=DEFAULT_WINDOW):
+        self._lock = threading.Lock()
+        self._samples = {name: deque(maxlen=window) for name, _, _ in STAGES}
+        self.recorded = 0
+
+    def record(self, trace):
+        marks = trace.marks
+        with self._lock:
+            for name, start, end in STAGES:
+                if start in marks and end in marks:
+                    self._samples[name].append(marks[end] - marks[start])
+            self.recorded += 1
+
+    def clear(self):
+        with self._lock:
+            for samples in self._samples.values():
+                samples.clear()
+            self.recorded = 0
+
+    def get_stats(self):
+        """Return {stage: {"count", "mean", "p50", "p95", "p99", "max"}} in milliseconds."""
+        with self._lock:
+            snapshot = {name: sorted(samples) for name, samples in self._samples.items()}
+        stats = {}
+        for name, _, _ in STAGES:
+            values = snapshot[name]
+            if not values:
+                continue
+            entry = {"count": len(values), "mean": sum(values) / len(values) * 1000.0}
+            for pct in PERCENTILES:
+                entry[f"p{pct}"] = percentile(values, pct) * 1000.0
+            entry["max"] = values[-1] * 1000.0
+            stats[name] = entry
+        return stats
+
+    def format_report(self):
+        """One line per stage, suitable for the NVDA log."""
+        stats = self.get_stats()
+        if not stats:
+            return "Unspoken latency: no sounds recorded"
+        lines = [f"Unspoken latency in ms ({self.recorded} sounds recorded):"]
+        for name, entry in stats.items():
+            lines.append(
+                f"  {name:<8} n={entry['count']:<5} p50={entry['p50']:7.2f} "
+                f"p95={entry['p95']:7.2f} p99={entry['p99']:7.2f} max={entry['max']:7.2f}"
+            )
+        return "\n".join(lines)
+
+    def log_report(self):
+        log.info(self.format_report())
+
+
+class DurationStats:
+    """Rolling window of one duration, safe to record into from any thread."""
+
+    def __init__(self, name, window=DEFAULT_WINDOW):
+        self.name = name
+        self._lock = threading.Lock()
+        self._samples = deque(maxlen=window)
+        self.recorded = 0
+
+    def record(self, seconds):
+        with self._lock:
+            self._samples.append(seconds)
+            self.recorded += 1
+
+    def clear(self):
+        with self._lock:
+            self._samples.clear()
+            self.recorded = 0
+
+    def get_stats(self):
+        """Return {"count", "mean", "p50", "p95", "p99", "max"} in milliseconds, or None if empty."""
+        with self._lock:
+            values = sorted(self._samples)
+        if not values:
+            return None
+        entry = {"count": len(values), "mean": sum(values) / len(values) * 1000.0}
+        for pct in PERCENTILES:
+            entry[f"p{pct}"] = percentile(values, pct) * 1000.0
+        entry["max"] = values[-1] * 1000.0
+        return entry
+
+    def format_report(self):
+        entry = self.get_stats()
+        if entry is None:
+            return f"Unspoken {self.name}: nothing recorded"
+        return (
+            f"Unspoken {self.name} in ms ({self.recorded} recorded): n={entry['count']} "
+            f"p50={entry['p50']:.2f} p95={entry['p95']:.2f} p99={entry['p99']:.2f} max={entry['max']:.2f}"
+        )
@@ -0,0 +1,41 @@
+"""
+Short-lived cache of NVDA object screen locations.
+
+Reading obj.location (and, inside documents, treeInterceptor.currentNVDAObject
+and its location) is a cross-process COM/IA2 call on NVDA's main thread.
+NVDA hands the add-on the same object instance several times in quick
+succession (focus, then the navigator following it, or repeated mouse moves
+within one object), so the location of each instance is kept for ttl seconds.
+Entries match by identity only: NVDAObject equality can itself cost a COM call.
+"""
+
+import time
+from collections import deque
+
+DEFAULT_TTL = 0.5
+DEFAULT_SIZE = 8
+
+
+class LocationCache:
+    """Most recent (object, location, expiry) entries, matched by identity. Main thread only."""
+
+    def __init__(self, ttl=DEFAULT_TTL, size=DEFAULT_SIZE):
+        self.ttl = ttl
+        self._entries = deque(maxlen=size)
+        self.hits = 0
+        self.misses = 0
+
+    def get(self, obj, fetch):
+        """Return obj's cached location, or fetch(obj) and cache it. Locations may be None."""
+        now = time.perf_counter()
+        for cached, location, expiry in self._entries:
+            if cached is obj and expiry > now:
+                self.hits += 1
+                return location
+        self.misses += 1
+        location = fetch(obj)
+        self._entries.append((obj, location, now + self.ttl))
+        return location
+
+    def clear(self):
+        self._entries.clear()
@@ -0,0 +1,55 @@
+"""
+Resident memory reporting for the add-on.
+
+NVDA runs all day, so what the add-on keeps resident matters more than what
+a single sound allocates. OpenALLoopback.memory_report() sizes each component
+the engine holds (sound bank, render cache, pooled render buffers, classic
+reverb); format_memory_report() turns that into one log line next to NVDA's
+working set, which the plugin writes with the latency report
+(NVDA+control+shift+u).
+"""
+
+import ctypes
+import sys
+
+
+class _PROCESS_MEMORY_COUNTERS(ctypes.Structure):
+    _fields_ = [
+        ("cb", ctypes.c_ulong),
+        ("PageFaultCount", ctypes.c_ulong),
+        ("PeakWorkingSetSize", ctypes.c_size_t),
+        ("WorkingSetSize", ctypes.c_size_t),
+        ("QuotaPeakPagedPoolUsage", ctypes.c_size_t),
+        ("QuotaPagedPoolUsage", ctypes.c_size_t),
+        ("QuotaPeakNonPagedPoolUsage", ctypes.c_size_t),
+        ("QuotaNonPagedPoolUsage", ctypes.c_size_t),
+        ("PagefileUsage", ctypes.c_size_t),
+        ("PeakPagefileUsage", ctypes.c_size_t),
+    ]
+
+
+def working_set_bytes():
+    """Current working set of this process (NVDA), or None if it cannot be read."""
+    if sys.platform != "win32":
+        return None
+    counters = _PROCESS_MEMORY_COUNTERS()
+    counters.cb = ctypes.sizeof(counters)
+    process = ctypes.windll.kernel32.GetCurrentProcess()
+    if not ctypes.windll.psapi.GetProcessMemoryInfo(process, ctypes.byref(counters), counters.cb):
+        return None
+    return counters.WorkingSetSize
+
+
+def _format_bytes(size):
+    if size >= 1024 * 1024:
+        return f"{size / (1024 * 1024):.1f} MiB"
+    return f"{size / 1024:.0f} KiB"
+
+
+def format_memory_report(components, working_set=None):
+    """One line listing each component's resident bytes, their total and the working set."""
+    parts = [f"{name} {_format_bytes(size)}" for name, size in components.items()]
+    line = "Unspoken memory: " + ", ".join(parts) + f"; total {_format_bytes(sum(components.values()))}"
+    if working_set is not None:
+        line += f" of NVDA's {_format_bytes(working_set)} working set"
+    return line
@@ -0,0 +1,174 @@
+"""
+Continuous loopback mixer for overlapping earcons.
+
+In mixing mode sounds are not rendered one at a time. They are started on the
+engine's voice pool (OpenALLoopback.start_voice), and one mixer thread renders
+everything playing in frame_size blocks with render_mix() and feeds the blocks
+to a single WavePlayer stream. New sounds overlap earlier ones instead of
+interrupting them, and there is no stop()/feed() cycle per sound.
+
+Rendering is paced against the wall clock so the mixer never runs more than
+max_lead_blocks ahead of playback; that lead is the added latency for a new
+sound. When no voice is playing and the reverb tail has stayed below the
+engine's tail floor, the mixer idles the WavePlayer and sleeps until the next
+sound.
+
+With always_on set the mixer never idles: it keeps rendering (silence, when
+nothing plays) into the one open WavePlayer stream, so the device never
+restarts and a new sound is only ever max_lead_blocks away from the speakers.
+"""
+
+import ctypes
+import threading
+import time
+
+from .openal_audio import TailTrimmer
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+
+class LoopbackMixer:
+    """Mixer thread driving an OpenALLoopback voice pool.
+
+    feed(data, size) and idle() are supplied by the owner and must be safe to call
+    from the mixer thread; they normally wrap the add-on's WavePlayer. data is a
+    c_void_p to the mixer's one block buffer, which is rendered over again as soon
+    as feed() returns, so feed() must copy it before returning (nvwave.WavePlayer
+    and DeviceOutput both do).
+    """
+
+    def __init__(self, engine, feed, idle, max_lead_blocks=3, always_on=False, latency=None, name="UnspokenMixer"):
+        self._engine = engine
+        # LatencyStats receiving the traces of sounds once their first block is fed
+        self._latency = latency
+        self._traces = []
+        self._feed = feed
+        self._idle = idle
+        self.max_lead_blocks = max_lead_blocks
+        self.always_on = always_on
+        self._cond = threading.Condition()
+        self._active = False
+        self._running = True
+        # Count of play() calls; lets the mixer tell whether a sound started after
+        # the block that it judged silent
+        self._plays = 0
+        self.blocks_rendered = 0
+        # Times rendering fell behind real-time playback
+        self.underruns = 0
+        self._thread = threading.Thread(target=self._run, name=name, daemon=True)
+        self._thread.start()
+
+    def play(self, sound_id, gain, angle_x, angle_y, distance=1.0, interrupt=False, trace=None):
+        """Start a sound on the voice pool, optionally stopping the voices already playing."""
+        if interrupt:
+            self._engine.stop_voices()
+        if not self._engine.start_voice(sound_id, gain, angle_x, angle_y, distance):
+            log.warn("Failed starting voice %r", sound_id)
+            return
+        with self._cond:
+            if trace is not None:
+                trace.mark("rendered")
+                self._traces.append(trace)
+            self._plays += 1
+            self._active = True
+            self._cond.notify()
+
+    def set_always_on(self, always_on):
+        """Switch always-on streaming; enabling it starts the stream immediately."""
+        with self._cond:
+            self.always_on = always_on
+            self._cond.notify()
+
+    def stop(self, timeout=1.0):
+        """Stop the mixer thread and silence the voice pool."""
+        with self._cond:
+            self._running = False
+            self._cond.notify()
+        if self._thread is not threading.current_thread():
+            self._thread.join(timeout)
+        self._engine.stop_voices()
+        self._engine.voices_settled()
+
+    def _run(self):
+        while True:
+            with self._cond:
+                while not (self._active or self.always_on) and self._running:
+                    self._cond.wait()
+                if not self._running:
+                    return
+            seen = serial = None
+            try:
+                seen, serial = self._mix_until_silent()
+            except Exception:
+                log.error("Unspoken mixer failed", exc_info=True)
+            with self._cond:
+                if seen is not None and seen != self._plays:
+                    # A sound started after the last rendered block; keep mixing
+                    continue
+                self._active = False
+            # A play() landing here started its voice after the silent block was
+            # judged; the engine then keeps the primary claimed for it
+            self._engine.voices_settled(serial)
+            try:
+                self._idle()
+            except Exception:
+                log.error("Unspoken mixer idle failed", exc_info=True)
+
+    def _mix_until_silent(self):
+        """Render and feed blocks until no voice plays and the tail is silent
+        (or, while always_on, until always_on is cleared and that holds).
+
+        Returns the play() count and the engine's voice_serial observed before
+        the final render.
+        """
+        engine = self._engine
+        frames = engine.frame_size
+        block_seconds = frames / engine.sample_rate
+        out_buf = (ctypes.c_int16 * (frames * 2))()
+        out_view = memoryview(out_buf).cast("B")
+        out_address = ctypes.c_void_p(ctypes.addressof(out_buf))
+        trimmer = None
+        start = time.perf_counter()
+        rendered = 0
+        plays = self._plays
+        serial = engine.voice_serial
+        while self._running:
+            plays = self._plays
+            serial = engine.voice_serial
+            voices_playing = engine.render_mix(out_buf, frames)
+            self.blocks_rendered += 1
+            rendered += 1
+            if voices_playing or self.always_on:
+                trimmer = None
+            else:
+                # Only the reverb tail is left; keep mixing until it falls silent
+                if trimmer is None:
+                    trimmer = TailTrimmer(engine.tail_floor_dbfs, engine.tail_hold_frames, frames)
+                if trimmer.scan(out_view):
+                    return plays, serial
+            self._feed(out_address, len(out_view))
+            if self._traces:
+                self._finish_traces()
+            # Stay at most max_lead_blocks ahead of real-time playback
+            ahead = rendered * block_seconds - (time.perf_counter() - start)
+            lead = self.max_lead_blocks * block_seconds
+            if ahead > lead:
+                time.sleep(ahead - lead)
+            elif ahead < 0:
+                # Fell behind (e.g. the WavePlayer was restarted); re-anchor the clock
+                self.underruns += 1
+                start = time.perf_counter()
+                rendered = 0
+        return plays, serial
+
+    def _finish_traces(self):
+        with self._cond:
+            traces = self._traces
+            self._traces = []
+        for trace in traces:
+            trace.mark("fed")
+            if self._latency is not None:
+                self._latency.record(trace)
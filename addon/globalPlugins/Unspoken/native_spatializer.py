@@ -0,0 +1,251 @@
+"""
+ctypes binding for the optional native spatializer (spatializer.dll, built from
+native/spatializer.cpp).
+
+The DLL performs gain, clamp, int16 conversion, buffer upload and the loopback
+render in one native call, so no per-sample work happens in Python and the GIL
+is released while rendering. process_batch renders a whole list of jobs, tails
+trimmed, in one such call. It also carries the classic Unspoken reverb
+(native/reverb.cpp), a block-based rewrite of v1's verblib, exposed here as
+NativeReverb. It is optional: if the DLL is missing or fails to initialize,
+load_native_spatializer() returns None and OpenALLoopback keeps using its pure
+ctypes path.
+"""
+
+import ctypes
+import os
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+# Must match the SAMPLE_FORMAT_* constants in spatializer.cpp.
+SAMPLE_FORMAT_INT16 = 0
+SAMPLE_FORMAT_FLOAT32 = 1
+
+
+class OpenALApi(ctypes.Structure):
+    """Mirror of struct OpenALApi in spatializer.cpp."""
+
+    _fields_ = [
+        ("alSourcei", ctypes.c_void_p),
+        ("alSourcef", ctypes.c_void_p),
+        ("alSource3f", ctypes.c_void_p),
+        ("alSource3i", ctypes.c_void_p),
+        ("alSourcePlay", ctypes.c_void_p),
+        ("alSourceStop", ctypes.c_void_p),
+        ("alBufferData", ctypes.c_void_p),
+        ("alcRenderSamplesSOFT", ctypes.c_void_p),
+    ]
+
+
+class RenderJob(ctypes.Structure):
+    """Mirror of struct RenderJob in spatializer.cpp."""
+
+    _fields_ = [
+        ("device", ctypes.c_void_p),
+        ("source", ctypes.c_uint),
+        ("buffer", ctypes.c_uint),
+        ("samples", ctypes.c_void_p),
+        ("sample_format", ctypes.c_int),
+        ("num_frames", ctypes.c_int),
+        ("sample_rate", ctypes.c_int),
+        ("gain", ctypes.c_float),
+        ("source_gain", ctypes.c_float),
+        ("position", ctypes.c_float * 3),
+        ("effect_slot", ctypes.c_uint),
+        ("tail_frames", ctypes.c_int),
+        ("reverb", ctypes.c_void_p),
+    ]
+
+
+class TailCut(ctypes.Structure):
+    """Mirror of struct TailCut in spatializer.cpp."""
+
+    _fields_ = [
+        ("threshold", ctypes.c_double),
+        ("hold_frames", ctypes.c_int),
+        ("block_frames", ctypes.c_int),
+        ("ceiling_frames", ctypes.c_int),
+    ]
+
+
+class NativeReverb:
+    """One classic reverb instance (struct Reverb in reverb.cpp).
+
+    Holds delay line state between calls, so a sound's tail carries on into the
+    next block. Not thread safe: each LoopbackContext owns one and uses it under
+    its lock.
+    """
+
+    def __init__(self, dll, handle):
+        self.dll = dll
+        self.handle = handle
+        # Fixed at allocation; kept here so memory_bytes() never touches a
+        # handle that close() may be freeing on another thread
+        self._memory_bytes = dll.reverb_memory_bytes(handle)
+
+    def set_params(self, room_size, damping, wet_level, dry_level, width):
+        """Set the add-on's normalized (0.0-1.0) reverb parameters, as verblib mapped them."""
+        self.dll.reverb_set_params(self.handle, room_size, damping, wet_level, dry_level, width)
+
+    def process(self, samples, num_frames):
+        """Apply the reverb in place to num_frames of a ctypes interleaved stereo int16 array."""
+        self.dll.reverb_process_int16(self.handle, samples, num_frames)
+
+    def reset(self):
+        self.dll.reverb_reset(self.handle)
+
+    def memory_bytes(self):
+        """Bytes allocated for this reverb's delay lines and state; safe from any thread."""
+        return self._memory_bytes if self.handle else 0
+
+    def close(self):
+        if self.handle:
+            self.dll.reverb_destroy(self.handle)
+            self.handle = None
+
+
+class NativeSpatializer:
+    """Thin wrapper over the spatializer.dll exports.
+
+    Callers must hold the render mutex of the context the job's handles belong to.
+    """
+
+    def __init__(self, dll, has_reverb=False, has_render_into=False, has_batch=False):
+        self.dll = dll
+        # False for a spatializer.dll built before reverb.cpp existed
+        self.has_reverb = has_reverb
+        # False for a spatializer.dll without process_sound_into
+        self.has_render_into = has_render_into
+        # False for a spatializer.dll without process_batch
+        self.has_batch = has_batch
+
+    def render(self, job):
+        """Run one RenderJob and return stereo int16 PCM bytes, or None on failure."""
+        out_ptr = ctypes.POINTER(ctypes.c_int16)()
+        out_frames = ctypes.c_int(0)
+        if not self.dll.process_sound(ctypes.byref(job), ctypes.byref(out_ptr), ctypes.byref(out_frames)):
+            return None
+        try:
+            return ctypes.string_at(out_ptr, out_frames.value * 2 * ctypes.sizeof(ctypes.c_int16))
+        finally:
+            self.dll.free_output_sound(out_ptr)
+
+    def render_into(self, job, out_buf, capacity_frames):
+        """Run one RenderJob into out_buf, a ctypes stereo int16 array of capacity_frames.
+
+        Returns the frames written, or None on failure or if the render does not fit.
+        """
+        out_frames = ctypes.c_int(0)
+        if not self.dll.process_sound_into(ctypes.byref(job), out_buf, capacity_frames, ctypes.byref(out_frames)):
+            return None
+        return out_frames.value
+
+    def render_batch(self, jobs, cut, arena, capacity_frames, offsets, frames):
+        """Run a ctypes array of RenderJobs back to back into arena, trimming tails per cut.
+
+        arena is a ctypes stereo int16 array of capacity_frames (or its address);
+        offsets and frames are ctypes int arrays as long as jobs, receiving each
+        job's start and length in arena frames (0 frames for a failed job).
+        Returns the number of jobs processed; fewer than len(jobs) if the arena filled.
+        """
+        return self.dll.process_batch(jobs, len(jobs), ctypes.byref(cut), arena, capacity_frames, offsets, frames)
+
+    def create_reverb(self, sample_rate):
+        """Return a new NativeReverb for sample_rate, or None if unsupported or out of memory."""
+        if not self.has_reverb:
+            return None
+        handle = self.dll.reverb_create(sample_rate)
+        if not handle:
+            log.error("Native spatializer could not allocate a classic reverb")
+            return None
+        return NativeReverb(self.dll, handle)
+
+
+def _openal_entry_points(openal_dll):
+    """Collect the addresses spatializer.dll calls from the loaded OpenAL Soft module.
+
+    Missing functions are left null, which initialize_spatializer rejects.
+    """
+    api = OpenALApi()
+    for name, _ in OpenALApi._fields_[:-1]:
+        try:
+            setattr(api, name, ctypes.cast(getattr(openal_dll, name), ctypes.c_void_p).value)
+        except AttributeError:
+            pass
+    api.alcRenderSamplesSOFT = openal_dll.alcGetProcAddress(None, b"alcRenderSamplesSOFT")
+    return api
+
+
+def load_native_spatializer(openal_dll, dll_path=None):
+    """Load spatializer.dll and bind it to the already loaded OpenAL Soft module.
+
+    openal_dll is the ctypes library openal_audio.py loaded; its entry points are
+    handed to the DLL, so the DLL never reopens the module by (ANSI) path.
+
+    Returns a NativeSpatializer, or None if the DLL is absent or cannot initialize.
+    """
+    if dll_path is None:
+        dll_path = os.path.join(os.path.dirname(__file__), "spatializer.dll")
+    if not os.path.exists(dll_path):
+        log.debug(f"Native spatializer not present at {dll_path}; using ctypes render path")
+        return None
+    try:
+        dll = ctypes.CDLL(dll_path)
+    except OSError as e:
+        log.warning(f"Native spatializer failed to load: {dll_path} -- {e}")
+        return None
+
+    dll.initialize_spatializer.argtypes = [ctypes.POINTER(OpenALApi)]
+    dll.initialize_spatializer.restype = ctypes.c_int
+    dll.process_sound.argtypes = [
+        ctypes.POINTER(RenderJob),
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_int16)),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    dll.process_sound.restype = ctypes.c_int
+    dll.free_output_sound.argtypes = [ctypes.POINTER(ctypes.c_int16)]
+    dll.free_output_sound.restype = None
+    has_render_into = hasattr(dll, "process_sound_into")
+    if has_render_into:
+        dll.process_sound_into.argtypes = [
+            ctypes.POINTER(RenderJob),
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int),
+        ]
+        dll.process_sound_into.restype = ctypes.c_int
+    has_batch = hasattr(dll, "process_batch")
+    if has_batch:
+        dll.process_batch.argtypes = [
+            ctypes.POINTER(RenderJob),
+            ctypes.c_int,
+            ctypes.POINTER(TailCut),
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+        ]
+        dll.process_batch.restype = ctypes.c_int
+    has_reverb = hasattr(dll, "reverb_create")
+    if has_reverb:
+        dll.reverb_create.argtypes = [ctypes.c_int]
+        dll.reverb_create.restype = ctypes.c_void_p
+        dll.reverb_destroy.argtypes = [ctypes.c_void_p]
+        dll.reverb_destroy.restype = None
+        dll.reverb_set_params.argtypes = [ctypes.c_void_p] + [ctypes.c_float] * 5
+        dll.reverb_set_params.restype = None
+        dll.reverb_reset.argtypes = [ctypes.c_void_p]
+        dll.reverb_reset.restype = None
+        dll.reverb_process_int16.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int]
+        dll.reverb_process_int16.restype = None
+        dll.reverb_memory_bytes.argtypes = [ctypes.c_void_p]
+        dll.reverb_memory_bytes.restype = ctypes.c_size_t
+
+    if not dll.initialize_spatializer(ctypes.byref(_openal_entry_points(openal_dll))):
+        log.warning("Native spatializer could not resolve OpenAL entry points; using ctypes render path")
+        return None
+    log.debug(f"Native spatializer loaded from: {dll_path}")
+    return NativeSpatializer(dll, has_reverb, has_render_into, has_batch)
@@ -2,20 +2,56 @@
 OpenAL Soft ctypes loopback wrapper for HRTF spatialization and EFX reverb.
 
 Uses ALC_SOFT_loopback: all rendering is synchronous inside
-alcRenderSamplesSOFT, with no background mixing thread. This matches the
-thread-per-sound architecture in __init__.py -- each ephemeral audio thread
-acquires _openal_audio_mutex, renders, and feeds bytes to nvwave.WavePlayer.
-nvwave.WavePlayer remains the sole audio output path, preserving NVDA ducking
-and device routing.
+alcRenderSamplesSOFT, with no background mixing thread. The add-on's render
+worker (audio_worker.py) locks a loopback context, renders, and hands the
+bytes to the playback worker, which feeds the output.
+
+initialize() opens a small pool of independent loopback devices, each with its
+own context, AL objects and lock (LoopbackContext). One-shot renders take any
+idle context, so they run in parallel; the primary context also carries
+streams and the mixer's voice pool. With ALC_EXT_thread_local_context each
+render makes its context current on its own thread; without it the pool has
+a single context.
+The rendered bytes normally go out through nvwave.WavePlayer, preserving NVDA
+ducking and device routing. With directOutput set they go to an OpenAL Soft
+playback device instead (device_output.DeviceOutput), for lower latency at the
+cost of NVDA's ducking.
 
 Requires soft_oal.dll (OpenAL Soft official Windows x64 build) in the same
 directory. DLL load failure raises OSError at import time.
+
+When spatializer.dll (native/spatializer.cpp) is present, int16 renders go
+through it instead: conversion and rendering run natively, outside the GIL.
+It also provides the classic reverb (use_classic_reverb), which replaces the
+EFX effect slot with v1's verblib network applied to each context's output.
+
+render_batch() renders many sound bank jobs back to back under one context
+lock into one contiguous arena; with spatializer.dll that is one native call.
+The cache pre-warmer and the benchmark fill caches through it.
 """
 
 import ctypes
+import glob
+import hashlib
 import math
 import os
+import sys
 import threading
+import wave
+from collections import namedtuple
+from contextlib import contextmanager
+
+from .disk_cache import file_fingerprint
+from .latency import TimedLock
+from .native_spatializer import (
+    SAMPLE_FORMAT_INT16,
+    RenderJob,
+    TailCut,
+    load_native_spatializer,
+)
+from . import pcm as pcm_kernels
+from .render_cache import RenderCache, quantize_angle
+from .spatial import PositionTable
 
 try:
     from logHandler import log
@@ -31,14 +67,23 @@ ALC_HRTF_SOFT = 0x1992
 ALC_FREQUENCY = 0x1007
 
 AL_FORMAT_MONO16 = 0x1101
+AL_FORMAT_STEREO16 = 0x1103
 AL_BUFFER = 0x1009
 AL_POSITION = 0x1004
 AL_GAIN = 0x100A
+AL_MAX_GAIN = 0x100E
+AL_SOURCE_STATE = 0x1010
+AL_PLAYING = 0x1012
+AL_BUFFERS_QUEUED = 0x1015
+AL_BUFFERS_PROCESSED = 0x1016
+# AL_SOFT_direct_channels: play a buffer's channels straight to the matching outputs
+AL_DIRECT_CHANNELS_SOFT = 0x1033
 AL_NONE = 0
 
 # EFX effect type constants
 AL_EFFECT_TYPE = 0x8001
 AL_EFFECT_REVERB = 0x0001
+AL_EFFECT_NULL = 0x0000
 
 # EFX reverb parameter constants
 AL_REVERB_DIFFUSION = 0x0002
@@ -55,10 +100,82 @@ AL_FILTER_NULL = 0x0000
 AL_NO_ERROR = 0
 ALC_NO_ERROR = 0
 
-# Module-level mutex serializes all OpenAL calls across thread-per-sound threads.
-# alcMakeContextCurrent is called once at initialize(); thereafter each thread
-# acquires this lock only for the alcRenderSamplesSOFT render window.
-_openal_audio_mutex = threading.Lock()
+# Lock of the primary loopback context; every other context gets its own.
+# A context's lock is held for any AL call on it, and only for the render
+# window. TimedLock lets the latency trace see how long a render waited.
+_openal_audio_mutex = TimedLock()
+
+# Loopback contexts opened by initialize(): the primary plus one for parallel
+# one-shot renders (cache pre-warming alongside a live sound).
+DEFAULT_CONTEXT_COUNT = 2
+
+
+# Source AL_MAX_GAIN; sound bank renders apply dry level times the synth-tracking
+# volume (up to 1.25 with the HRTF boost) as AL_GAIN, which must not be clamped at 1.0.
+MAX_SOURCE_GAIN = 2.0
+
+# One preloaded sound: frame count, the wav's own sample rate and a digest of its
+# samples (for disk cache keys). The AL buffer handles live in each
+# LoopbackContext's bank, one per device.
+BankSound = namedtuple("BankSound", ["frames", "sample_rate", "digest"])
+
+# Result of render_batch(): arena is a byte view of stereo int16 PCM holding every
+# job's render back to back; spans[i] is job i's (byte offset, byte length) in it,
+# or None if that job was not rendered.
+RenderBatch = namedtuple("RenderBatch", ["arena", "spans"])
+
+# Output rate when the device's mix rate is not known (see supports_sample_rate)
+DEFAULT_SAMPLE_RATE = 44100
+
+# Largest render (in frames) whose output buffer is kept for reuse by its context;
+# longer ones, which only the first renders under new reverb settings reach, get
+# a buffer of their own. 65536 frames is 256 KB per context.
+RENDER_BUFFER_POOL_FRAMES = 65536
+
+# Size of the voice pool used by the continuous mixer (mixer.py)
+DEFAULT_VOICE_COUNT = 8
+
+# Default adaptive tail cut: stop once the tail stays below -60 dBFS RMS for 4096
+# frames (~93 ms at 44.1 kHz).
+DEFAULT_TAIL_FLOOR_DBFS = -60.0
+DEFAULT_TAIL_HOLD_FRAMES = 4096
+
+# Classic reverb tail ceiling: comb feedback passes to -60 dB over the longest comb
+# delay (verblib's 1617 + 23 samples at 44.1 kHz), capped like the longest EFX decay
+CLASSIC_LONGEST_COMB = (1617 + 23) / 44100.0
+CLASSIC_TAIL_MAX_SECONDS = 8.0
+
+
+class TailTrimmer:
+    """Find where a rendered reverb tail stays below an RMS floor.
+
+    scan() is fed consecutive stretches of stereo int16 tail PCM and measures RMS
+    per block_frames block. Once quiet blocks add up to hold_frames in a row it
+    returns True; quiet_start is then the tail frame offset where that quiet run
+    began, i.e. the effective tail length. A louder block resets the run.
+    """
+
+    def __init__(self, floor_dbfs, hold_frames, block_frames):
+        level = 32767.0 * 10.0 ** (floor_dbfs / 20.0)
+        # Mean square per sample below which a block is quiet
+        self.threshold = level * level
+        self.hold_frames = hold_frames
+        self.block_frames = block_frames
+        self.quiet_start = None
+        self.position = 0
+
+    def scan(self, pcm):
+        for energy, count in pcm_kernels.block_energies(pcm, self.block_frames * 2):
+            frames = count // 2
+            if energy < self.threshold * count:
+                if self.quiet_start is None:
+                    self.quiet_start = self.position
+                if self.position + frames - self.quiet_start >= self.hold_frames:
+                    return True
+            else:
+                self.quiet_start = None
+            self.position += frames
+        return False
 
 
 def _load_openal_dll(dll_path):
@@ -83,6 +200,13 @@ def _load_openal_dll(dll_path):
     dll.alcCloseDevice.restype = ctypes.c_int
     dll.alcGetError.argtypes = [ctypes.c_void_p]
     dll.alcGetError.restype = ctypes.c_int
+    # Playback devices (device_output.py)
+    dll.alcOpenDevice.argtypes = [ctypes.c_char_p]
+    dll.alcOpenDevice.restype = ctypes.c_void_p
+    dll.alcIsExtensionPresent.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+    dll.alcIsExtensionPresent.restype = ctypes.c_int
+    dll.alcGetString.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    dll.alcGetString.restype = ctypes.c_void_p
 
     # AL source/buffer functions
     dll.alGenSources.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_uint)]
@@ -107,6 +231,12 @@ def _load_openal_dll(dll_path):
     dll.alSourcePlay.restype = None
     dll.alSourceStop.argtypes = [ctypes.c_uint]
     dll.alSourceStop.restype = None
+    dll.alGetSourcei.argtypes = [ctypes.c_uint, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+    dll.alGetSourcei.restype = None
+    dll.alSourceQueueBuffers.argtypes = [ctypes.c_uint, ctypes.c_int, ctypes.POINTER(ctypes.c_uint)]
+    dll.alSourceQueueBuffers.restype = None
+    dll.alSourceUnqueueBuffers.argtypes = [ctypes.c_uint, ctypes.c_int, ctypes.POINTER(ctypes.c_uint)]
+    dll.alSourceUnqueueBuffers.restype = None
     dll.alGetError.argtypes = []
     dll.alGetError.restype = ctypes.c_int
 
@@ -129,6 +259,41 @@ def _load_openal_dll(dll_path):
     return dll
 
 
+class LoopbackContext:
+    """One loopback device and context with its own AL objects and lock.
+
+    AL object names are only valid on the device that created them, so each
+    context has its own render source, scratch buffer, reverb effect and slot,
+    and its own copy of every sound bank buffer. Use it only through
+    OpenALLoopback._locked or _render_context, which also make it current.
+    """
+
+    def __init__(self, lock):
+        self.lock = lock
+        self.device = None
+        self.context = None
+        self.source = ctypes.c_uint(0)
+        self.buffer = ctypes.c_uint(0)
+        self.effect = ctypes.c_uint(0)
+        self.effect_slot = ctypes.c_uint(0)
+        # sound_id -> AL buffer of that sound on this device
+        self.bank = {}
+        # Incremented whenever a render takes over the source; lets a stream
+        # detect that it has been superseded.
+        self.render_serial = 0
+        # OpenALLoopback._settings_version last applied to effect (and reverb)
+        self.settings_version = 0
+        # NativeReverb run on everything rendered here while the classic reverb is on
+        self.reverb = None
+        # Set while a stream or the voice pool may have left a reverb tail ringing
+        # here at full level; the next sound started clears it (_clear_stale_reverb)
+        self.reverb_dirty = False
+        # Reused output buffers for one-shot renders and their tail extension
+        # blocks (OpenALLoopback._output_buffer, _block_buffer)
+        self.render_buffer = None
+        self.block_buffer = None
+
+
 class OpenALLoopback:
     """ctypes wrapper around soft_oal.dll providing HRTF spatialization and EFX reverb
     via the ALC_SOFT_loopback extension.
@@ -142,26 +307,66 @@ class OpenALLoopback:
         self.dll = None
         self.initialized = False
         self._mutex = _openal_audio_mutex
-        self._device = None
-        self._context = None
-        self._source = ctypes.c_uint(0)
-        self._buffer = ctypes.c_uint(0)
-        self._effect = ctypes.c_uint(0)
-        self._effect_slot = ctypes.c_uint(0)
-        self.sample_rate = 44100
+        # Loopback context pool; _contexts[0] is the primary context
+        self._contexts = []
+        self._primary = None
+        self.sample_rate = DEFAULT_SAMPLE_RATE
         self.frame_size = 1024
         self._dry_level = 0.3
         self._reverb_enabled = False
         self._reverb_tail_frames = 0
+        self._efx_decay_time = 0.0
+        # True while the native classic reverb stands in for the EFX slot
+        self._classic_reverb = False
+        # Hashable snapshot of every setting that affects rendered output; part of
+        # each render cache key so renders from old settings are never served.
+        self._reverb_params = None
+        self._reverb_key = (False, None)
+        # EFX reverb values from set_reverb_settings. Contexts apply them when next
+        # locked if their settings_version is behind, so a settings change never
+        # waits for a busy context.
+        self._efx_values = None
+        self._settings_version = 0
+        self.render_cache = RenderCache()
+        # Source positions of the render cache's angle grid, computed once
+        self._positions = PositionTable()
+        # Optional DiskRenderCache behind render_cache (attach_disk_cache)
+        self.disk_cache = None
+        # Called with no arguments after the reverb key changes (and the cache is cleared)
+        self._reverb_listeners = []
+        # Adaptive tail truncation (see TailTrimmer). _tail_estimates maps a reverb
+        # key to the longest effective tail measured under it, in frames.
+        self.tail_floor_dbfs = DEFAULT_TAIL_FLOOR_DBFS
+        self.tail_hold_frames = DEFAULT_TAIL_HOLD_FRAMES
+        self._tail_estimates = {}
+        # Sound bank: sound_id -> BankSound, one AL buffer per distinct wav file and context
+        self._bank = {}
+        # Voice pool for the continuous mixer: AL sources plus the start order of
+        # each, so the oldest voice is stolen when all are busy
+        self._voices = None
+        self._voice_started = []
+        self._voice_serial = 0
+        # Streams and the voice pool currently using the primary context, changed
+        # under its lock; one-shot renders stay off the primary while any are.
+        # _primary_free is notified when the count drops to zero.
+        self._primary_users = 0
+        self._primary_free = threading.Condition()
+        self._pool_claimed = False
 
         # Loopback extension functions loaded via alcGetProcAddress
         self._alcLoopbackOpenDeviceSOFT = None
         self._alcIsRenderFormatSupportedSOFT = None
         self._alcRenderSamplesSOFT = None
+        # ALC_EXT_thread_local_context, needed for more than one context; may be None
+        self._alcSetThreadContext = None
+
+        # Optional spatializer.dll fast path; None means the ctypes path is used
+        self._native = None
 
         if dll_path is None:
             addon_dir = os.path.dirname(__file__)
             dll_path = os.path.join(addon_dir, "soft_oal.dll")
+        self.dll_path = dll_path
 
         try:
             self.dll = _load_openal_dll(dll_path)
@@ -170,6 +375,8 @@ class OpenALLoopback:
         except OSError as e:
             log.error(f"OpenAL Soft DLL not found or failed to load: {dll_path} -- {e}")
             self.dll = None
+            return
+        self._native = load_native_spatializer(self.dll)
 
     def _load_loopback_extensions(self):
         """Load ALC_SOFT_loopback extension functions via alcGetProcAddress."""
@@ -195,6 +402,12 @@ class OpenALLoopback:
             addr,
             ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int)
         )
+        addr = get_proc(None, b"alcSetThreadContext")
+        if addr:
+            self._alcSetThreadContext = ctypes.cast(
+                addr,
+                ctypes.CFUNCTYPE(ctypes.c_int, ctypes.c_void_p)
+            )
 
     def _check_al_error(self, context_msg):
         """Log warning if OpenAL error is pending; does not raise."""
@@ -208,18 +421,20 @@ class OpenALLoopback:
         if err != ALC_NO_ERROR:
             log.warning(f"ALC error {err:#x} after {context_msg}")
 
-    @staticmethod
-    def _float_to_int16(float_samples):
-        """Convert float32 samples in [-1,1] to int16 PCM array."""
-        n = len(float_samples)
-        arr = (ctypes.c_int16 * n)()
-        for i, s in enumerate(float_samples):
-            clamped = max(-1.0, min(1.0, s))
-            arr[i] = int(clamped * 32767)
-        return arr
-
-    def initialize(self, sample_rate=44100, frame_size=1024):
-        """Open loopback device, create HRTF context, and allocate persistent AL objects.
+    # Whole-buffer kernels; see pcm.py
+    _float_to_int16 = staticmethod(pcm_kernels.float_to_int16)
+
+    def _source_position(self, angle_x, angle_y, distance=1.0):
+        """Map azimuth/elevation in degrees and distance to an AL source position (see spatial.py)."""
+        return self._positions.position(angle_x, angle_y, distance)
+
+    def initialize(self, sample_rate=DEFAULT_SAMPLE_RATE, frame_size=1024, voice_count=DEFAULT_VOICE_COUNT,
+                   context_count=DEFAULT_CONTEXT_COUNT):
+        """Open the loopback context pool and allocate persistent AL objects.
+
+        context_count loopback devices are opened (one if the OpenAL build lacks
+        ALC_EXT_thread_local_context). voice_count sources are allocated on the
+        primary context for the continuous mixer's voice pool.
 
         Returns True on success, False on failure.
         """
@@ -228,94 +443,285 @@ class OpenALLoopback:
         if self.initialized:
             log.debug("OpenAL already initialized")
             return True
+        if context_count > 1 and self._alcSetThreadContext is None:
+            log.warning("ALC_EXT_thread_local_context unavailable; using a single loopback context")
+            context_count = 1
 
-        with self._mutex:
-            device = None
-            context = None
-            try:
-                # Open virtual loopback device -- no audio hardware involved
-                device = self._alcLoopbackOpenDeviceSOFT(None)
-                if not device:
-                    log.error("alcLoopbackOpenDeviceSOFT returned NULL")
-                    return False
-
-                # Validate stereo short format before context creation
-                if not self._alcIsRenderFormatSupportedSOFT(
-                    device, sample_rate, ALC_STEREO_SOFT, ALC_SHORT_SOFT
-                ):
-                    log.error("Loopback render format not supported")
-                    self.dll.alcCloseDevice(device)
-                    return False
-
-                # Context attributes: loopback format + HRTF enabled
-                attrs = (ctypes.c_int * 9)(
-                    ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
-                    ALC_FORMAT_TYPE_SOFT, ALC_SHORT_SOFT,
-                    ALC_FREQUENCY, sample_rate,
-                    ALC_HRTF_SOFT, 1,
-                    0,
-                )
-                context = self.dll.alcCreateContext(device, attrs)
-                if not context:
-                    log.error("alcCreateContext failed")
-                    self.dll.alcCloseDevice(device)
-                    return False
-                self.dll.alcMakeContextCurrent(context)
-                self._check_alc_error(device, "alcMakeContextCurrent")
-
-                # Verify HRTF activated; log warning but continue if unavailable
-                hrtf_status = ctypes.c_int(0)
-                self.dll.alcGetIntegerv(device, ALC_HRTF_SOFT, 1, ctypes.byref(hrtf_status))
-                if not hrtf_status.value:
-                    log.warning("HRTF not available on loopback device; stereo panning will be used")
-
-                # Persistent reusable source and buffer for all process_sound calls
-                self.dll.alGenSources(1, ctypes.byref(self._source))
-                self.dll.alGenBuffers(1, ctypes.byref(self._buffer))
-
-                # EFX reverb effect and auxiliary slot setup
-                self.dll.alGenEffects(1, ctypes.byref(self._effect))
-                self._check_al_error("alGenEffects")
-                self.dll.alEffecti(self._effect.value, AL_EFFECT_TYPE, AL_EFFECT_REVERB)
-                self.dll.alGenAuxiliaryEffectSlots(1, ctypes.byref(self._effect_slot))
-                self._check_al_error("alGenAuxiliaryEffectSlots")
-                self.dll.alAuxiliaryEffectSloti(self._effect_slot.value, AL_EFFECTSLOT_EFFECT, self._effect.value)
-
-                self._device = device
-                self._context = context
-                self.sample_rate = sample_rate
-                self.frame_size = frame_size
-                self.initialized = True
-                log.debug(f"OpenAL Soft initialized: {sample_rate}Hz, HRTF={bool(hrtf_status.value)}")
-                return True
-
-            except Exception as e:
-                log.error(f"OpenAL initialization failed: {e}")
-                if context:
-                    self.dll.alcMakeContextCurrent(None)
-                    self.dll.alcDestroyContext(context)
-                if device:
-                    self.dll.alcCloseDevice(device)
+        contexts = []
+        try:
+            for index in range(max(1, context_count)):
+                ctx = LoopbackContext(self._mutex if index == 0 else TimedLock())
+                with ctx.lock:
+                    opened = self._open_context(ctx, sample_rate)
+                if not opened:
+                    break
+                contexts.append(ctx)
+        except Exception as e:
+            log.error(f"OpenAL initialization failed: {e}")
+        if not contexts:
+            return False
+        if len(contexts) < context_count:
+            log.warning(f"Opened {len(contexts)} of {context_count} loopback contexts")
+
+        primary = contexts[0]
+        with primary.lock:
+            # Threads that never set a thread context fall back to the primary
+            self.dll.alcMakeContextCurrent(primary.context)
+            self._check_alc_error(primary.device, "alcMakeContextCurrent")
+            if self._alcSetThreadContext is not None:
+                self._alcSetThreadContext(primary.context)
+            self._voices = (ctypes.c_uint * voice_count)()
+            self.dll.alGenSources(voice_count, self._voices)
+            self._check_al_error("alGenSources voice pool")
+            for voice in self._voices:
+                self.dll.alSourcef(voice, AL_MAX_GAIN, ctypes.c_float(MAX_SOURCE_GAIN))
+            self._voice_started = [0] * voice_count
+
+        self._contexts = contexts
+        self._primary = primary
+        self.sample_rate = sample_rate
+        self.frame_size = frame_size
+        self.initialized = True
+        return True
+
+    def supports_sample_rate(self, sample_rate):
+        """Whether loopback devices can render stereo int16 at sample_rate. Callable before initialize()."""
+        if self.dll is None:
+            return False
+        device = self._alcLoopbackOpenDeviceSOFT(None)
+        if not device:
+            return False
+        try:
+            return bool(self._alcIsRenderFormatSupportedSOFT(device, sample_rate, ALC_STEREO_SOFT, ALC_SHORT_SOFT))
+        finally:
+            self.dll.alcCloseDevice(device)
+
+    def _open_context(self, ctx, sample_rate):
+        """Open ctx's loopback device and HRTF context and create its AL objects.
+
+        Leaves the new context current on this thread. Caller holds ctx.lock.
+        Returns True on success, False (with nothing left open) on failure.
+        """
+        device = None
+        context = None
+        try:
+            # Open virtual loopback device -- no audio hardware involved
+            device = self._alcLoopbackOpenDeviceSOFT(None)
+            if not device:
+                log.error("alcLoopbackOpenDeviceSOFT returned NULL")
+                return False
+
+            # Validate stereo short format before context creation
+            if not self._alcIsRenderFormatSupportedSOFT(
+                device, sample_rate, ALC_STEREO_SOFT, ALC_SHORT_SOFT
+            ):
+                log.error("Loopback render format not supported")
+                self.dll.alcCloseDevice(device)
                 return False
 
+            # Context attributes: loopback format + HRTF enabled
+            attrs = (ctypes.c_int * 9)(
+                ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+                ALC_FORMAT_TYPE_SOFT, ALC_SHORT_SOFT,
+                ALC_FREQUENCY, sample_rate,
+                ALC_HRTF_SOFT, 1,
+                0,
+            )
+            context = self.dll.alcCreateContext(device, attrs)
+            if not context:
+                log.error("alcCreateContext failed")
+                self.dll.alcCloseDevice(device)
+                return False
+            if self._alcSetThreadContext is not None:
+                self._alcSetThreadContext(context)
+            else:
+                self.dll.alcMakeContextCurrent(context)
+            self._check_alc_error(device, "make context current")
+
+            # Verify HRTF activated; log warning but continue if unavailable
+            hrtf_status = ctypes.c_int(0)
+            self.dll.alcGetIntegerv(device, ALC_HRTF_SOFT, 1, ctypes.byref(hrtf_status))
+            if not hrtf_status.value:
+                log.warning("HRTF not available on loopback device; stereo panning will be used")
+
+            # Persistent reusable source for all renders, and a scratch buffer for
+            # process_sound/process_pcm16 data that is not in the sound bank
+            self.dll.alGenSources(1, ctypes.byref(ctx.source))
+            self.dll.alGenBuffers(1, ctypes.byref(ctx.buffer))
+            self.dll.alSourcef(ctx.source.value, AL_MAX_GAIN, ctypes.c_float(MAX_SOURCE_GAIN))
+
+            # EFX reverb effect and auxiliary slot setup
+            self.dll.alGenEffects(1, ctypes.byref(ctx.effect))
+            self._check_al_error("alGenEffects")
+            self.dll.alEffecti(ctx.effect.value, AL_EFFECT_TYPE, AL_EFFECT_REVERB)
+            self.dll.alGenAuxiliaryEffectSlots(1, ctypes.byref(ctx.effect_slot))
+            self._check_al_error("alGenAuxiliaryEffectSlots")
+            self.dll.alAuxiliaryEffectSloti(ctx.effect_slot.value, AL_EFFECTSLOT_EFFECT, ctx.effect.value)
+
+            ctx.device = device
+            ctx.context = context
+            log.debug(f"OpenAL Soft initialized: {sample_rate}Hz, HRTF={bool(hrtf_status.value)}")
+            return True
+
+        except Exception as e:
+            log.error(f"OpenAL initialization failed: {e}")
+            if context:
+                if self._alcSetThreadContext is not None:
+                    self._alcSetThreadContext(None)
+                self.dll.alcMakeContextCurrent(None)
+                self.dll.alcDestroyContext(context)
+            if device:
+                self.dll.alcCloseDevice(device)
+            return False
+
     def cleanup(self):
-        """Release all AL objects, destroy context, and close loopback device."""
+        """Release all AL objects, destroy every context, and close the loopback devices."""
         if not self.initialized:
             return
-        with self._mutex:
-            self.dll.alSourceStop(self._source.value)
-            self.dll.alDeleteSources(1, ctypes.byref(self._source))
-            self.dll.alDeleteBuffers(1, ctypes.byref(self._buffer))
-            self.dll.alDeleteEffects(1, ctypes.byref(self._effect))
-            self.dll.alDeleteAuxiliaryEffectSlots(1, ctypes.byref(self._effect_slot))
-            self.dll.alcMakeContextCurrent(None)
-            self.dll.alcDestroyContext(self._context)
-            self.dll.alcCloseDevice(self._device)
-            self._context = None
-            self._device = None
-            self.initialized = False
+        log.debug(f"Render cache stats: {self.render_cache.get_stats()}")
+        if self.disk_cache is not None:
+            log.debug(f"Disk render cache stats: {self.disk_cache.get_stats()}")
+        self.render_cache.clear()
+        with self._locked(self._primary):
+            for voice in self._voices:
+                self.dll.alSourceStop(voice)
+            self.dll.alDeleteSources(len(self._voices), self._voices)
+            self._voices = None
+        for ctx in self._contexts:
+            with self._locked(ctx):
+                self.dll.alSourceStop(ctx.source.value)
+                self.dll.alDeleteSources(1, ctypes.byref(ctx.source))
+                self.dll.alDeleteBuffers(1, ctypes.byref(ctx.buffer))
+                for buffer in ctx.bank.values():
+                    self.dll.alDeleteBuffers(1, ctypes.byref(buffer))
+                ctx.bank.clear()
+                if ctx.reverb is not None:
+                    ctx.reverb.close()
+                    ctx.reverb = None
+                ctx.render_buffer = None
+                ctx.block_buffer = None
+                self.dll.alDeleteEffects(1, ctypes.byref(ctx.effect))
+                self.dll.alDeleteAuxiliaryEffectSlots(1, ctypes.byref(ctx.effect_slot))
+                if self._alcSetThreadContext is not None:
+                    self._alcSetThreadContext(None)
+                self.dll.alcMakeContextCurrent(None)
+                self.dll.alcDestroyContext(ctx.context)
+                self.dll.alcCloseDevice(ctx.device)
+                ctx.context = None
+                ctx.device = None
+        self._bank.clear()
+        self._contexts = []
+        self._primary = None
+        self.initialized = False
         log.debug("OpenAL Soft cleaned up")
 
+    @contextmanager
+    def _locked(self, ctx):
+        """Hold ctx's lock with ctx current on this thread and its reverb up to date."""
+        with ctx.lock:
+            self._enter(ctx)
+            yield ctx
+
+    @property
+    def uses_native_spatializer(self):
+        """Whether renders go through spatializer.dll rather than the pure ctypes path."""
+        return self._native is not None
+
+    @property
+    def has_background_context(self):
+        """Whether there is a secondary context, so background renders never touch the primary."""
+        return len(self._contexts) > 1
+
+    @contextmanager
+    def _render_context(self, background=False):
+        """Lock and yield an idle context for a one-shot render.
+
+        Secondary contexts are tried first. Rendering on the primary would stop its
+        stream source and advance the mixer's voices, so a one-shot only takes the
+        primary while no stream or voice pool is using it; background renders (the
+        pre-warmer's batches) never do. Otherwise this waits for the first secondary
+        context or, if there is none, for the primary to be released.
+        """
+        for ctx in self._contexts[1:]:
+            if ctx.lock.acquire(False):
+                break
+        else:
+            ctx = self._wait_for_context(background)
+        try:
+            self._enter(ctx)
+            yield ctx
+        finally:
+            ctx.lock.release()
+
+    def _wait_for_context(self, background):
+        """Lock and return a context once no secondary one was idle (see _render_context)."""
+        primary = self._primary
+        if not background and primary.lock.acquire(False):
+            if not self._primary_users:
+                return primary
+            primary.lock.release()
+        if len(self._contexts) > 1:
+            ctx = self._contexts[1]
+            ctx.lock.acquire()
+            return ctx
+        while True:
+            with self._primary_free:
+                while self._primary_users:
+                    self._primary_free.wait()
+            primary.lock.acquire()
+            # Users only join under the primary lock, so this holds until it is released
+            if not self._primary_users:
+                return primary
+            primary.lock.release()
+
+    def _claim_primary(self):
+        """Count a stream or the voice pool as using the primary. Caller holds the primary lock."""
+        with self._primary_free:
+            self._primary_users += 1
+
+    def _release_primary(self):
+        """Undo one _claim_primary(). Caller holds the primary lock."""
+        with self._primary_free:
+            self._primary_users -= 1
+            if not self._primary_users:
+                self._primary_free.notify_all()
+
+    def _enter(self, ctx):
+        """Make ctx current on this thread and apply pending reverb settings. Caller holds ctx.lock."""
+        if self._alcSetThreadContext is not None:
+            self._alcSetThreadContext(ctx.context)
+        if ctx.settings_version != self._settings_version:
+            self._apply_reverb(ctx)
+
+    def _apply_reverb(self, ctx):
+        """Write the current EFX reverb values to ctx's effect, and set up its classic reverb. Caller holds ctx.lock."""
+        version = self._settings_version
+        if self._classic_reverb:
+            if ctx.reverb is None:
+                ctx.reverb = self._native.create_reverb(self.sample_rate)
+            if ctx.reverb is not None and self._reverb_params is not None:
+                ctx.reverb.set_params(*self._reverb_params)
+                # A tail left by the old parameters must not run into the new ones
+                ctx.reverb.reset()
+        elif ctx.reverb is not None:
+            ctx.reverb.close()
+            ctx.reverb = None
+        values = self._efx_values
+        if values is not None:
+            decay_time, gainhf, gain, diffusion = values
+            self.dll.alEffectf(ctx.effect.value, AL_REVERB_DECAY_TIME, ctypes.c_float(decay_time))
+            self._check_al_error("alEffectf AL_REVERB_DECAY_TIME")
+            self.dll.alEffectf(ctx.effect.value, AL_REVERB_GAINHF, ctypes.c_float(gainhf))
+            self._check_al_error("alEffectf AL_REVERB_GAINHF")
+            self.dll.alEffectf(ctx.effect.value, AL_REVERB_GAIN, ctypes.c_float(gain))
+            self._check_al_error("alEffectf AL_REVERB_GAIN")
+            self.dll.alEffectf(ctx.effect.value, AL_REVERB_DIFFUSION, ctypes.c_float(diffusion))
+            self._check_al_error("alEffectf AL_REVERB_DIFFUSION")
+
+            # Reattach effect to slot after parameter change
+            self.dll.alAuxiliaryEffectSloti(ctx.effect_slot.value, AL_EFFECTSLOT_EFFECT, ctx.effect.value)
+        ctx.settings_version = version
+
     def __del__(self):
         if getattr(self, "initialized", False):
             self.cleanup()
@@ -326,6 +732,9 @@ class OpenALLoopback:
         dry_level is applied as AL_GAIN on the source at render time -- EFX separates
         dry/wet control at the source level, not the effect level.
 
+        Idle contexts are updated immediately; a context that is rendering picks the
+        new values up the next time it is locked, so this never waits for a render.
+
         Returns True on success, False if not initialized.
         """
         if self.dll is None:
@@ -334,41 +743,485 @@ class OpenALLoopback:
             log.error("OpenAL not initialized")
             return False
 
-        with self._mutex:
-            # Map addon parameters (0.0-1.0) to EFX reverb values.
-            decay_time = 0.1 + room_size * 3.9
-            gainhf = 1.0 - damping * 0.9
-            gain = wet_level * 0.5
-            diffusion = width
+        # Map addon parameters (0.0-1.0) to EFX reverb values.
+        decay_time = 0.1 + room_size * 3.9
+        gainhf = 1.0 - damping * 0.9
+        gain = wet_level * 0.5
+        diffusion = width
 
-            self._dry_level = dry_level
+        self._dry_level = dry_level
+        self._efx_values = (decay_time, gainhf, gain, diffusion)
+        self._efx_decay_time = decay_time
+        self._settings_version += 1
 
-            self.dll.alEffectf(self._effect.value, AL_REVERB_DECAY_TIME, ctypes.c_float(decay_time))
-            self._check_al_error("alEffectf AL_REVERB_DECAY_TIME")
-            self.dll.alEffectf(self._effect.value, AL_REVERB_GAINHF, ctypes.c_float(gainhf))
-            self._check_al_error("alEffectf AL_REVERB_GAINHF")
-            self.dll.alEffectf(self._effect.value, AL_REVERB_GAIN, ctypes.c_float(gain))
-            self._check_al_error("alEffectf AL_REVERB_GAIN")
-            self.dll.alEffectf(self._effect.value, AL_REVERB_DIFFUSION, ctypes.c_float(diffusion))
-            self._check_al_error("alEffectf AL_REVERB_DIFFUSION")
+        self._reverb_params = (room_size, damping, wet_level, dry_level, width)
+        self._update_tail_frames()
+        self._update_reverb_key()
 
-            # Reattach effect to slot after parameter change
-            self.dll.alAuxiliaryEffectSloti(self._effect_slot.value, AL_EFFECTSLOT_EFFECT, self._effect.value)
-
-            # Reverb tail: int(decay_time * sample_rate * 2) frames.
-            # The *2 multiplier provides headroom for the full decay envelope.
-            self._reverb_tail_frames = int(decay_time * self.sample_rate * 2)
+        for ctx in self._contexts:
+            if ctx.lock.acquire(False):
+                try:
+                    self._enter(ctx)
+                finally:
+                    ctx.lock.release()
 
-            log.debug(f"Reverb settings updated: decay={decay_time:.2f}s, gainhf={gainhf:.2f}, gain={gain:.2f}")
-            return True
+        log.debug(f"Reverb settings updated: decay={decay_time:.2f}s, gainhf={gainhf:.2f}, gain={gain:.2f}")
+        return True
 
     def enable_reverb(self, enabled):
         """Toggle reverb processing; wired to config.conf[unspoken][Reverb] checkbox."""
         self._reverb_enabled = bool(enabled)
-        if not enabled:
+        self._update_tail_frames()
+        self._update_reverb_key()
+
+    def use_classic_reverb(self, enabled):
+        """Choose the classic (verblib) reverb instead of EFX; wired to config.conf[unspoken][classicReverb].
+
+        The classic reverb needs spatializer.dll. It takes over the dry level too, so
+        sources play at full gain and it mixes dry and wet as v1 did. Returns True if
+        the classic reverb is now in use.
+        """
+        if enabled and (self._native is None or not self._native.has_reverb):
+            log.warning("Classic reverb needs spatializer.dll with reverb support; using EFX reverb")
+            enabled = False
+        enabled = bool(enabled)
+        if enabled != self._classic_reverb:
+            self._classic_reverb = enabled
+            self._settings_version += 1
+            for ctx in self._contexts:
+                if ctx.lock.acquire(False):
+                    try:
+                        self._enter(ctx)
+                    finally:
+                        ctx.lock.release()
+            self._update_tail_frames()
+            self._update_reverb_key()
+        return enabled
+
+    def _update_tail_frames(self):
+        """Recompute the reverb tail ceiling for the active reverb and its settings."""
+        if not self._reverb_enabled:
             self._reverb_tail_frames = 0
+        elif self._classic_reverb and self._reverb_params is not None:
+            feedback = self._reverb_params[0] * 0.28 + 0.7
+            seconds = math.log(1e-3) / math.log(feedback) * CLASSIC_LONGEST_COMB
+            self._reverb_tail_frames = int(min(seconds, CLASSIC_TAIL_MAX_SECONDS) * self.sample_rate)
+        else:
+            # int(decay_time * sample_rate * 2) frames; the *2 multiplier provides
+            # headroom for the full decay envelope.
+            self._reverb_tail_frames = int(self._efx_decay_time * self.sample_rate * 2)
+
+    def _clear_stale_reverb(self, ctx):
+        """Silence the reverb tail a superseded stream or the voice pool left on ctx. Caller holds ctx.lock.
+
+        Otherwise the next render on ctx would carry another sound's tail, and
+        cache it under its own key.
+        """
+        if not ctx.reverb_dirty:
+            return
+        if ctx.reverb is not None:
+            ctx.reverb.reset()
+        # A slot only gets a fresh effect state when its effect changes
+        self.dll.alAuxiliaryEffectSloti(ctx.effect_slot.value, AL_EFFECTSLOT_EFFECT, AL_EFFECT_NULL)
+        self.dll.alAuxiliaryEffectSloti(ctx.effect_slot.value, AL_EFFECTSLOT_EFFECT, ctx.effect.value)
+        self._check_al_error("alAuxiliaryEffectSloti reset")
+        ctx.reverb_dirty = False
+
+    def _efx_send(self, ctx):
+        """Effect slot a source on ctx sends to: the EFX reverb's, or 0 for none."""
+        if self._reverb_enabled and not self._classic_reverb:
+            return ctx.effect_slot.value
+        return 0
+
+    def _source_level(self):
+        """AL_GAIN for unit volume: the dry level, unless the classic reverb applies it."""
+        if self._reverb_enabled and self._classic_reverb:
+            return 1.0
+        return self._dry_level
+
+    def _output_reverb(self, ctx):
+        """ctx's NativeReverb if the classic reverb is active, else None. Caller holds ctx.lock."""
+        if self._reverb_enabled and self._classic_reverb:
+            return ctx.reverb
+        return None
+
+    def _render_block(self, ctx, out_buf, num_frames):
+        """Render num_frames from ctx's device into out_buf, through the classic reverb if active."""
+        self._alcRenderSamplesSOFT(ctx.device, out_buf, num_frames)
+        reverb = self._output_reverb(ctx)
+        if reverb is not None:
+            reverb.process(out_buf, num_frames)
+
+    def set_tail_floor(self, floor_dbfs, hold_frames=None):
+        """Set the RMS level (dBFS) and hold length (frames) at which reverb tails are cut."""
+        self.tail_floor_dbfs = float(floor_dbfs)
+        if hold_frames is not None:
+            self.tail_hold_frames = int(hold_frames)
+        self._update_reverb_key()
+
+    def _update_reverb_key(self):
+        """Recompute the reverb key and drop cached renders made under the previous one."""
+        key = (
+            self._reverb_enabled,
+            self._classic_reverb,
+            self._reverb_params,
+            self.tail_floor_dbfs,
+            self.tail_hold_frames,
+        )
+        if key != self._reverb_key:
+            self._reverb_key = key
+            self.render_cache.clear()
+            for listener in list(self._reverb_listeners):
+                try:
+                    listener()
+                except Exception:
+                    log.error("Reverb settings listener failed", exc_info=True)
+
+    def memory_report(self):
+        """Return {component: resident bytes} for the memory this engine keeps.
+
+        The sound bank counts every context's copy of the AL buffers (held in OpenAL
+        Soft's heap), the render cache its PCM, render buffers the pooled output
+        buffers, and the classic reverb its delay lines.
+        """
+        contexts = list(self._contexts)
+        bank = sum(sound.frames * 2 for sound in self._bank.values()) * len(contexts)
+        buffers = 0
+        reverb = 0
+        for ctx in contexts:
+            for buffer in (ctx.render_buffer, ctx.block_buffer):
+                if buffer is not None:
+                    buffers += ctypes.sizeof(buffer)
+            # Read without the context lock; memory_bytes() never calls into the DLL
+            classic = ctx.reverb
+            if classic is not None:
+                reverb += classic.memory_bytes()
+        return {
+            "sound bank": bank,
+            "render cache": self.render_cache.get_stats()["bytes"],
+            "render buffers": buffers,
+            "classic reverb": reverb,
+        }
+
+    def disk_fingerprint(self):
+        """Identify everything besides the cache key that shapes a render.
+
+        Covers the OpenAL Soft DLL and any HRTF data sets (*.mhr) beside it, and the
+        output sample rate; a DiskRenderCache built for another fingerprint is discarded.
+        """
+        paths = [self.dll_path] + sorted(glob.glob(os.path.join(os.path.dirname(self.dll_path), "*.mhr")))
+        return {"files": file_fingerprint(paths), "sample_rate": self.sample_rate}
+
+    def attach_disk_cache(self, disk_cache):
+        """Use disk_cache (a DiskRenderCache, or None) as a second level behind render_cache."""
+        self.disk_cache = disk_cache
+
+    def disk_key(self, key):
+        """Map a render cache key to a disk cache key that is stable across restarts."""
+        sound_id, q_x, q_y, distance, volume, reverb_key = key
+        sound = self._bank.get(sound_id)
+        if sound is None:
+            return None
+        reverb_digest = hashlib.sha1(repr(reverb_key).encode("utf-8")).hexdigest()[:16]
+        # Unit-distance keys keep the format they had before distance existed
+        position = f"{q_x:g}:{q_y:g}" if distance == 1.0 else f"{q_x:g}:{q_y:g}@{distance:g}"
+        return f"{sound.digest}:{position}:{volume:g}:{reverb_digest}"
+
+    def _from_disk(self, key):
+        """Return PCM for key from the disk cache, promoting it into render_cache, or None."""
+        disk_cache = self.disk_cache
+        if disk_cache is None:
+            return None
+        disk_key = self.disk_key(key)
+        if disk_key is None:
+            return None
+        pcm = disk_cache.get(disk_key)
+        if pcm is not None:
+            self.render_cache.put(key, pcm)
+        return pcm
+
+    def _store(self, key, pcm):
+        """Cache a finished render in memory and, if attached, on disk."""
+        self.render_cache.put(key, pcm)
+        disk_cache = self.disk_cache
+        if disk_cache is not None:
+            disk_key = self.disk_key(key)
+            if disk_key is not None:
+                disk_cache.put(disk_key, pcm)
+
+    def add_reverb_listener(self, listener):
+        """Register listener() to be called whenever cached renders are invalidated."""
+        self._reverb_listeners.append(listener)
+
+    def remove_reverb_listener(self, listener):
+        if listener in self._reverb_listeners:
+            self._reverb_listeners.remove(listener)
+
+    def render_key(self, sound_id, angle_x, angle_y, volume, distance=1.0):
+        """Return the render cache key for a sound at the given (quantized) position.
+
+        Angles already on the grid (spatial.ScreenMap cells) are their own key.
+        """
+        return (
+            sound_id,
+            quantize_angle(angle_x),
+            quantize_angle(angle_y),
+            distance,
+            round(volume, 2),
+            self._reverb_key,
+        )
+
+    def load_sound(self, sound_id, path):
+        """Decode a 16-bit wav once and upload it into its own sound bank AL buffer.
+
+        Every loopback context gets its own copy, since AL buffers belong to one
+        device. Renders of sound_id then only rebind it. Stereo files keep the left
+        channel. Files at another rate are resampled to the output rate here, once,
+        so OpenAL never resamples while rendering. Loading an already loaded
+        sound_id is a no-op.
+
+        Returns True on success, False on failure.
+        """
+        if self.dll is None or not self.initialized:
+            return False
+        if sound_id in self._bank:
+            return True
+        try:
+            with wave.open(path, "rb") as wav_file:
+                frames = wav_file.readframes(wav_file.getnframes())
+                sample_width = wav_file.getsampwidth()
+                channels = wav_file.getnchannels()
+                sample_rate = wav_file.getframerate()
+        except (OSError, EOFError, wave.Error) as e:
+            log.error(f"Failed to load {path}: {e}")
+            return False
+        if sample_width != 2:
+            log.error(f"Unsupported sample width in {path}: {sample_width}")
+            return False
+        if channels != 1 or sys.byteorder == "big":
+            # Source WAV files are mono or have identical channels;
+            # if not mono, we take the left channel only as it's sufficient
+            frames = pcm_kernels.first_channel(frames, channels)
+        if sample_rate != self.sample_rate:
+            frames = pcm_kernels.resample_int16(frames, sample_rate, self.sample_rate)
+            sample_rate = self.sample_rate
+        num_frames = len(frames) // 2
+        if not num_frames:
+            log.error(f"No audio in {path}")
+            return False
+
+        for ctx in self._contexts:
+            buffer = ctypes.c_uint(0)
+            with self._locked(ctx):
+                self.dll.alGenBuffers(1, ctypes.byref(buffer))
+                self.dll.alBufferData(buffer.value, AL_FORMAT_MONO16, frames, len(frames), sample_rate)
+                self._check_al_error(f"alBufferData {sound_id}")
+                ctx.bank[sound_id] = buffer
+        digest = hashlib.sha1(frames).hexdigest()[:16]
+        self._bank[sound_id] = BankSound(num_frames, sample_rate, f"{digest}@{sample_rate}")
+        return True
+
+    def render_earcon(self, sound_id, angle_x, angle_y, volume, distance=1.0):
+        """Return spatialized PCM for a sound bank entry, rendering only on a render cache miss.
+
+        Angles are snapped to the cache grid before rendering so every position in a
+        grid cell shares one entry. Returns None if rendering failed.
+        """
+        key = self.render_key(sound_id, angle_x, angle_y, volume, distance)
+        cached = self.render_cache.get(key)
+        if cached is None:
+            cached = self._from_disk(key)
+        if cached is not None:
+            return cached
+        return self._render_into_cache(key, volume)
+
+    def warm_batch(self, cells, volume):
+        """Render (sound_id, angle_x, angle_y, distance) cells into the render cache in one render_batch().
+
+        The batch counterpart of warm_earcon(): cells already cached, in memory or
+        on disk, are not rendered. Returns the PCM bytes added per cell (0 if
+        already cached or on failure).
+        """
+        added = [0] * len(cells)
+        pending = {}
+        for index, (sound_id, angle_x, angle_y, distance) in enumerate(cells):
+            key = self.render_key(sound_id, angle_x, angle_y, volume, distance)
+            if key in self.render_cache or key in pending:
+                continue
+            cached = self._from_disk(key)
+            if cached is not None:
+                added[index] = len(cached)
+                continue
+            pending[key] = index
+        if not pending:
+            return added
+        keys = list(pending)
+        batch = self.render_batch([(key[0], key[1], key[2], volume, key[3]) for key in keys])
+        for key, span in zip(keys, batch.spans):
+            if span is None:
+                continue
+            offset, length = span
+            # As in _render_into_cache, a render that raced a settings change is not cached
+            if key[5] == self._reverb_key:
+                self._store(key, bytes(batch.arena[offset:offset + length]))
+            added[pending[key]] = length
+        return added
+
+    def warm_earcon(self, sound_id, angle_x, angle_y, volume, distance=1.0):
+        """Render a sound bank entry into the render cache unless it is already there.
+
+        Used by the cache pre-warmer; does not count as a cache lookup. Returns the
+        number of PCM bytes added to the cache (0 if already cached or on failure).
+        """
+        key = self.render_key(sound_id, angle_x, angle_y, volume, distance)
+        if key in self.render_cache:
+            return 0
+        rendered = self._from_disk(key) or self._render_into_cache(key, volume)
+        return len(rendered) if rendered else 0
+
+    def _render_into_cache(self, key, volume):
+        sound_id, q_x, q_y, distance, _, reverb_key = key
+        rendered = self.render_bank_sound(sound_id, volume, q_x, q_y, distance)
+        # Settings may have changed mid-render; such a result is still correct for
+        # this request but must not be cached under the new settings.
+        if rendered and reverb_key == self._reverb_key:
+            self._store(key, rendered)
+        return rendered
+
+    def sound_seconds(self, sound_id):
+        """Length of a loaded sound in seconds, without its reverb tail, or None."""
+        sound = self._bank.get(sound_id)
+        if sound is None:
+            return None
+        return sound.frames / sound.sample_rate
+
+    def _bank_frames(self, sound_id):
+        """Return the output-rate frame count of a loaded sound, or None."""
+        if self.dll is None or not self.initialized:
+            return None
+        sound = self._bank.get(sound_id)
+        if sound is None:
+            log.error(f"Sound not loaded: {sound_id}")
+            return None
+        # Input length in output-rate frames, so the tail starts where the sound ends
+        return -(-sound.frames * self.sample_rate // sound.sample_rate)
+
+    def render_bank_sound(self, sound_id, gain, angle_x, angle_y, distance=1.0):
+        """Spatialize a preloaded sound at gain and return stereo int16 PCM bytes.
 
-    def process_sound(self, input_samples, angle_x, angle_y):
+        Nothing is uploaded: the sound's buffer is bound to the source and gain is
+        folded into AL_GAIN. Returns None if not initialized or sound_id is not loaded.
+        """
+        num_input_frames = self._bank_frames(sound_id)
+        if num_input_frames is None:
+            return None
+        with self._render_context() as ctx:
+            buffer_id = ctx.bank[sound_id].value
+            if self._native is not None:
+                return self._render_native(ctx, buffer_id, num_input_frames, angle_x, angle_y, source_gain=gain,
+                                           distance=distance)
+            self._start_source(ctx, buffer_id, angle_x, angle_y, gain, distance)
+            return self._render_started(ctx, num_input_frames)
+
+    def render_batch(self, jobs):
+        """Spatialize many preloaded sounds back to back under one render context lock.
+
+        jobs are (sound_id, angle_x, angle_y, gain) tuples, optionally with a fifth
+        distance; each is rendered as render_bank_sound() would render it, reverb
+        tail trimmed, and the renders are packed into one arena. With
+        spatializer.dll the whole batch is a single native call outside the GIL.
+        Returns a RenderBatch; jobs whose sound is not loaded or that failed have
+        no span.
+        """
+        jobs = list(jobs)
+        spans = [None] * len(jobs)
+        frames = [self._bank_frames(job[0]) for job in jobs]
+        wanted = [index for index, num_frames in enumerate(frames) if num_frames is not None]
+        if not wanted:
+            return RenderBatch(memoryview(b""), spans)
+        with self._render_context(background=True) as ctx:
+            if self._native is not None and self._native.has_batch:
+                return self._render_batch_native(ctx, jobs, frames, wanted, spans)
+            arena = bytearray()
+            for index in wanted:
+                sound_id, angle_x, angle_y, gain = jobs[index][:4]
+                distance = jobs[index][4] if len(jobs[index]) > 4 else 1.0
+                buffer_id = ctx.bank[sound_id].value
+                if self._native is not None:
+                    rendered = self._render_native(ctx, buffer_id, frames[index], angle_x, angle_y,
+                                                   source_gain=gain, distance=distance)
+                else:
+                    self._start_source(ctx, buffer_id, angle_x, angle_y, gain, distance)
+                    rendered = self._render_started(ctx, frames[index])
+                if rendered:
+                    spans[index] = (len(arena), len(rendered))
+                    arena += rendered
+            return RenderBatch(memoryview(arena), spans)
+
+    def _render_batch_native(self, ctx, jobs, frames, wanted, spans):
+        """render_batch() through spatializer.dll's process_batch. Caller holds ctx.lock."""
+        reverb = self._output_reverb(ctx)
+        ceiling, tail_frames = self._tail_budget()
+        count = len(wanted)
+        native_jobs = (RenderJob * count)()
+        for job, index in zip(native_jobs, wanted):
+            sound_id, angle_x, angle_y, gain = jobs[index][:4]
+            distance = jobs[index][4] if len(jobs[index]) > 4 else 1.0
+            job.device = ctx.device
+            job.source = ctx.source.value
+            job.buffer = ctx.bank[sound_id].value
+            job.sample_format = SAMPLE_FORMAT_INT16
+            job.num_frames = frames[index]
+            job.sample_rate = self.sample_rate
+            job.gain = 1.0
+            job.source_gain = self._source_level() * gain
+            job.position[:] = self._source_position(angle_x, angle_y, distance)
+            job.effect_slot = self._efx_send(ctx)
+            job.tail_frames = tail_frames
+            job.reverb = reverb.handle if reverb is not None else None
+        cut = TailCut(self._new_trimmer().threshold, self.tail_hold_frames, self.frame_size, ceiling)
+        offsets = (ctypes.c_int * count)()
+        lengths = (ctypes.c_int * count)()
+        # Room for every job's first render plus one job's whole ceiling; process_batch
+        # stops early if tails run longer, and the arena grows for the rest
+        capacity = sum(frames[index] for index in wanted) + count * tail_frames + ceiling - tail_frames
+        arena = (ctypes.c_int16 * (capacity * 2))()
+        ctx.render_serial += 1
+        self._clear_stale_reverb(ctx)
+        done = 0
+        used = 0
+        while done < count:
+            remaining = count - done
+            processed = self._native.render_batch(
+                (RenderJob * remaining).from_buffer(native_jobs, done * ctypes.sizeof(RenderJob)),
+                cut,
+                ctypes.addressof(arena) + used * 4,
+                capacity - used,
+                (ctypes.c_int * remaining).from_buffer(offsets, done * ctypes.sizeof(ctypes.c_int)),
+                (ctypes.c_int * remaining).from_buffer(lengths, done * ctypes.sizeof(ctypes.c_int)),
+            )
+            for k in range(done, done + processed):
+                offsets[k] += used
+                if lengths[k]:
+                    self._record_tail(lengths[k] - native_jobs[k].num_frames)
+            if processed:
+                used = offsets[done + processed - 1] + lengths[done + processed - 1]
+            elif capacity - used >= native_jobs[done].num_frames + ceiling:
+                log.error("Native spatializer batch render failed")
+                break
+            done += processed
+            if done < count and processed < remaining:
+                capacity = used + sum(native_jobs[k].num_frames + ceiling for k in range(done, count))
+                grown = (ctypes.c_int16 * (capacity * 2))()
+                ctypes.memmove(grown, arena, used * 4)
+                arena = grown
+        view = memoryview(arena).cast("B")[:used * 4]
+        for k, index in enumerate(wanted[:done]):
+            if lengths[k]:
+                spans[index] = (offsets[k] * 4, lengths[k] * 4)
+        return RenderBatch(view, spans)
+
+    def process_sound(self, input_samples, angle_x, angle_y, volume=1.0):
         """Spatialize mono float32 samples and return stereo int16 PCM bytes.
 
         Uploads input_samples to an AL buffer, positions the source in 3D space using
@@ -379,6 +1232,9 @@ class OpenALLoopback:
         When reverb is enabled, render window is extended by _reverb_tail_frames to capture
         the full EFX decay after the source completes.
 
+        volume (the synth-tracking volume, up to 1.25 with the HRTF boost) is folded
+        into AL_GAIN with the dry level; the samples themselves are never scaled.
+
         Returns bytes suitable for nvwave.WavePlayer.feed() (stereo 16-bit PCM, interleaved).
         Returns None if not initialized or DLL failed to load.
         """
@@ -388,85 +1244,469 @@ class OpenALLoopback:
             log.error("OpenAL not initialized")
             return None
 
-        with self._mutex:
-            # Detach buffer from source before re-uploading data.
-            # alBufferData fails on a buffer still attached to a source (even stopped).
-            self.dll.alSourcei(self._source.value, AL_BUFFER, AL_NONE)
-
-            # Convert float32 mono samples to int16 PCM for OpenAL buffer upload
-            pcm_data = self._float_to_int16(input_samples)
-            num_input_frames = len(input_samples)
-            byte_size = num_input_frames * ctypes.sizeof(ctypes.c_int16)
-
-            self.dll.alBufferData(
-                self._buffer.value,
-                AL_FORMAT_MONO16,
-                pcm_data,
-                byte_size,
-                self.sample_rate,
-            )
-            self._check_al_error("alBufferData")
-
-            # Attach buffer and position source as unit direction vector for HRTF.
-            # Raw degree values would place the source far from the listener,
-            # causing near-silence from OpenAL's distance attenuation model.
-            self.dll.alSourcei(self._source.value, AL_BUFFER, self._buffer.value)
-            rad_x = math.radians(angle_x)
-            rad_y = math.radians(angle_y)
-            pos_x = math.sin(rad_x) * math.cos(rad_y)
-            pos_y = math.sin(rad_y)
-            pos_z = -math.cos(rad_x) * math.cos(rad_y)
-            self.dll.alSource3f(
-                self._source.value, AL_POSITION,
-                ctypes.c_float(pos_x), ctypes.c_float(pos_y), ctypes.c_float(pos_z)
+        # Convert float32 mono samples to int16 PCM for OpenAL buffer upload
+        pcm_data = self._float_to_int16(input_samples)
+        return self._render_int16(pcm_data, len(pcm_data), angle_x, angle_y, volume)
+
+    def process_pcm16(self, pcm, gain, angle_x, angle_y):
+        """Spatialize mono int16 PCM at gain and return stereo int16 PCM bytes.
+
+        pcm is any buffer-protocol object of native-endian int16 samples (typically
+        array('h')); it is uploaded as is, without a copy unless it is read-only, and
+        gain is folded into AL_GAIN. Uses spatializer.dll when available so the upload
+        and render happen in one native call; otherwise falls back to the ctypes path.
+
+        Returns None if not initialized or DLL failed to load.
+        """
+        if self.dll is None:
+            return None
+        if not self.initialized:
+            log.error("OpenAL not initialized")
+            return None
+
+        samples = self._int16_samples(pcm)
+        num_input_frames = len(samples)
+        if self._native is None:
+            return self._render_int16(samples, num_input_frames, angle_x, angle_y, gain)
+
+        with self._render_context() as ctx:
+            return self._render_native(
+                ctx, ctx.buffer.value, num_input_frames, angle_x, angle_y, source_gain=gain, samples=samples
             )
-            # Dry level is the source gain; EFX separates dry/wet at source level
-            self.dll.alSourcef(self._source.value, AL_GAIN, ctypes.c_float(self._dry_level))
-
-            if self._reverb_enabled:
-                self.dll.alSource3i(
-                    self._source.value, AL_AUXILIARY_SEND_FILTER,
-                    self._effect_slot.value, 0, AL_FILTER_NULL
-                )
-            else:
-                # Disconnect from EFX slot when reverb disabled
-                self.dll.alSource3i(self._source.value, AL_AUXILIARY_SEND_FILTER, 0, 0, AL_FILTER_NULL)
 
-            self.dll.alSourcePlay(self._source.value)
-            self._check_al_error("alSourcePlay")
+    @staticmethod
+    def _int16_samples(pcm):
+        """Wrap int16 PCM (any buffer-protocol object) as a ctypes array, copying only read-only buffers."""
+        view = memoryview(pcm).cast("B")
+        num_samples = len(view) // 2
+        try:
+            return (ctypes.c_int16 * num_samples).from_buffer(view)
+        except TypeError:
+            # Read-only buffers (bytes) cannot be referenced in place
+            return (ctypes.c_int16 * num_samples).from_buffer_copy(view)
+
+    def _render_native(self, ctx, buffer_id, num_input_frames, angle_x, angle_y, source_gain=1.0, samples=None,
+                       distance=1.0):
+        """Render through spatializer.dll on ctx. Caller holds ctx.lock.
+
+        With int16 samples, they are uploaded into buffer_id as is first; without,
+        buffer_id already holds the sound (sound bank). source_gain multiplies the
+        dry level on AL_GAIN. The classic reverb, if active, runs inside the same call.
+        """
+        reverb = self._output_reverb(ctx)
+        ctx.render_serial += 1
+        self._clear_stale_reverb(ctx)
+        ceiling, tail_frames = self._tail_budget()
+        job = RenderJob(
+            device=ctx.device,
+            source=ctx.source.value,
+            buffer=buffer_id,
+            samples=ctypes.addressof(samples) if samples is not None else None,
+            sample_format=SAMPLE_FORMAT_INT16,
+            num_frames=num_input_frames,
+            sample_rate=self.sample_rate,
+            # Gain is folded into AL_GAIN, so the samples are not scaled
+            gain=1.0,
+            source_gain=self._source_level() * source_gain,
+            position=self._source_position(angle_x, angle_y, distance),
+            effect_slot=self._efx_send(ctx),
+            tail_frames=tail_frames,
+            reverb=reverb.handle if reverb is not None else None,
+        )
+        if self._native.has_render_into:
+            # Render into the context's pooled buffer; _finish_tail makes the one copy
+            total_frames = num_input_frames + tail_frames
+            out_buf = self._output_buffer(ctx, total_frames)
+            frames = self._native.render_into(job, out_buf, total_frames)
+            if frames is None:
+                return None
+            rendered = memoryview(out_buf).cast("B")[:frames * 4]
+        else:
+            rendered = self._native.render(job)
+            if rendered is None:
+                return None
+        return self._finish_tail(ctx, rendered, num_input_frames, ceiling)
+
+    def _tail_budget(self):
+        """Return (ceiling, first_render) reverb tail frame counts for the current settings.
+
+        The ceiling is the fixed decay-based worst case. The first render covers the
+        longest tail measured so far under these settings (plus the hold window), so
+        a warm estimate usually finishes in one render call.
+        """
+        if not self._reverb_enabled:
+            return 0, 0
+        ceiling = self._reverb_tail_frames
+        estimate = self._tail_estimates.get(self._reverb_key)
+        if estimate is None:
+            return ceiling, ceiling
+        return ceiling, min(ceiling, estimate + self.tail_hold_frames)
+
+    def _record_tail(self, tail_frames):
+        """Remember the effective tail length for the current settings."""
+        if len(self._tail_estimates) >= 64:
+            self._tail_estimates.clear()
+        key = self._reverb_key
+        self._tail_estimates[key] = max(tail_frames, self._tail_estimates.get(key, 0))
+
+    def _new_trimmer(self):
+        return TailTrimmer(self.tail_floor_dbfs, self.tail_hold_frames, self.frame_size)
+
+    def _output_buffer(self, ctx, num_frames):
+        """Return a stereo int16 buffer for num_frames, ctx's pooled one if it fits the pool. Caller holds ctx.lock."""
+        if num_frames > RENDER_BUFFER_POOL_FRAMES:
+            return (ctypes.c_int16 * (num_frames * 2))()
+        buffer = ctx.render_buffer
+        if buffer is None or len(buffer) < num_frames * 2:
+            buffer = ctx.render_buffer = (ctypes.c_int16 * (num_frames * 2))()
+        return buffer
+
+    def _block_buffer(self, ctx):
+        """Return ctx's pooled frame_size stereo int16 buffer. Caller holds ctx.lock."""
+        if ctx.block_buffer is None:
+            ctx.block_buffer = (ctypes.c_int16 * (self.frame_size * 2))()
+        return ctx.block_buffer
+
+    def _finish_tail(self, ctx, rendered, num_input_frames, ceiling):
+        """Cut a finished render where its tail falls silent, extending it if it has not yet.
+
+        rendered (bytes, or a byte view of a pooled buffer) holds the input plus the
+        first tail render. If its tail is still above the floor, further frame_size
+        blocks are rendered up to ceiling. Returns bytes ending at the start of the
+        final quiet run, copied out of rendered once. Caller holds ctx.lock.
+        """
+        if ceiling == 0:
+            return bytes(rendered)
+        trimmer = self._new_trimmer()
+        view = memoryview(rendered)
+        chunks = [view]
+        tail_frames = len(view) // 4 - num_input_frames
+        done = trimmer.scan(view[num_input_frames * 4:])
+        if not done and tail_frames < ceiling:
+            block = self._block_buffer(ctx)
+            while not done and tail_frames < ceiling:
+                frames = min(self.frame_size, ceiling - tail_frames)
+                self._render_block(ctx, block, frames)
+                chunk = bytes(memoryview(block).cast("B")[:frames * 4])
+                chunks.append(chunk)
+                tail_frames += frames
+                done = trimmer.scan(chunk)
+        effective = trimmer.quiet_start if done else tail_frames
+        self._record_tail(effective)
+        end = (num_input_frames + effective) * 4
+        if len(chunks) == 1:
+            if end >= len(view) and isinstance(rendered, bytes):
+                return rendered
+            return bytes(view[:end])
+        data = b"".join(chunks)
+        return data if end >= len(data) else data[:end]
+
+    def _upload_scratch(self, ctx, pcm_data, num_input_frames):
+        """Upload a ctypes int16 array into ctx's scratch buffer. Caller must hold ctx.lock."""
+        # Detach buffer from source before re-uploading data.
+        # alBufferData fails on a buffer still attached to a source (even stopped).
+        self.dll.alSourceStop(ctx.source.value)
+        self.dll.alSourcei(ctx.source.value, AL_BUFFER, AL_NONE)
+
+        byte_size = num_input_frames * ctypes.sizeof(ctypes.c_int16)
+
+        self.dll.alBufferData(
+            ctx.buffer.value,
+            AL_FORMAT_MONO16,
+            pcm_data,
+            byte_size,
+            self.sample_rate,
+        )
+        self._check_al_error("alBufferData")
+
+    def _start_source(self, ctx, buffer_id, angle_x, angle_y, gain=1.0, distance=1.0):
+        """Bind buffer_id to ctx's source, position it and start playing.
+
+        gain multiplies the dry level on AL_GAIN. Caller must hold ctx.lock.
+        Bumps the render serial, which ends any stream still rendering from the source.
+        The classic reverb restarts from silence, as in spatializer.dll's jobs; only
+        the mixer's voices (_play_on) share its state.
+        """
+        ctx.render_serial += 1
+        self._clear_stale_reverb(ctx)
+        reverb = self._output_reverb(ctx)
+        if reverb is not None:
+            reverb.reset()
+        self._play_on(ctx, ctx.source.value, buffer_id, angle_x, angle_y, gain, distance)
+
+    def _play_on(self, ctx, source, buffer_id, angle_x, angle_y, gain, distance=1.0):
+        """Start buffer_id on an AL source of ctx at the given position. Caller must hold ctx.lock."""
+        # A superseded stream may leave the source playing; buffers can only be
+        # rebound on a stopped source.
+        self.dll.alSourceStop(source)
+
+        # Attach buffer and position source along its direction vector for HRTF.
+        self.dll.alSourcei(source, AL_BUFFER, buffer_id)
+        pos_x, pos_y, pos_z = self._source_position(angle_x, angle_y, distance)
+        self.dll.alSource3f(
+            source, AL_POSITION,
+            ctypes.c_float(pos_x), ctypes.c_float(pos_y), ctypes.c_float(pos_z)
+        )
+        # Dry level is the source gain; EFX separates dry/wet at source level
+        self.dll.alSourcef(source, AL_GAIN, ctypes.c_float(self._source_level() * gain))
+
+        # Disconnected from the EFX slot when reverb is off or the classic one is used
+        self.dll.alSource3i(source, AL_AUXILIARY_SEND_FILTER, self._efx_send(ctx), 0, AL_FILTER_NULL)
+
+        self.dll.alSourcePlay(source)
+        self._check_al_error("alSourcePlay")
+
+    def _render_started(self, ctx, num_input_frames):
+        """Render ctx's started source plus its reverb tail. Caller must hold ctx.lock."""
+        # Reverb tail extends render window to capture decay after source completes;
+        # _finish_tail extends or trims it to where the tail actually falls silent.
+        ceiling, tail_frames = self._tail_budget()
+        num_frames = num_input_frames + tail_frames
+
+        # Stereo output: 2 samples per frame (HRTF binaural output)
+        out_buf = self._output_buffer(ctx, num_frames)
+        self._render_block(ctx, out_buf, num_frames)
+        self._check_alc_error(ctx.device, "alcRenderSamplesSOFT")
+        rendered = self._finish_tail(
+            ctx, memoryview(out_buf).cast("B")[:num_frames * 4], num_input_frames, ceiling
+        )
+
+        self.dll.alSourceStop(ctx.source.value)
+        return rendered
 
-            # Reverb tail extends render window to capture decay after source completes
-            tail_frames = self._reverb_tail_frames if self._reverb_enabled else 0
-            num_frames = num_input_frames + tail_frames
+    def _render_int16(self, pcm_data, num_input_frames, angle_x, angle_y, gain=1.0):
+        """Play a ctypes int16 array at gain through a render context and render it plus the reverb tail."""
+        with self._render_context() as ctx:
+            self._upload_scratch(ctx, pcm_data, num_input_frames)
+            self._start_source(ctx, ctx.buffer.value, angle_x, angle_y, gain)
+            return self._render_started(ctx, num_input_frames)
 
-            # Stereo output: 2 samples per frame (HRTF binaural output)
-            out_buf = (ctypes.c_int16 * (num_frames * 2))()
-            self._alcRenderSamplesSOFT(self._device, out_buf, num_frames)
-            self._check_alc_error(self._device, "alcRenderSamplesSOFT")
+    def stream_pcm16(self, pcm, gain, angle_x, angle_y):
+        """Generator variant of process_pcm16 yielding stereo int16 PCM in frame_size chunks.
 
-            self.dll.alSourceStop(self._source.value)
-            return bytes(out_buf)
+        See _stream_started for chunking, tail and supersession behaviour.
+        """
+        if self.dll is None or not self.initialized:
+            return False
+        pcm_data = self._int16_samples(pcm)
+        num_input_frames = len(pcm_data)
+        ctx = self._primary
+        with self._locked(ctx):
+            self._upload_scratch(ctx, pcm_data, num_input_frames)
+            self._start_source(ctx, ctx.buffer.value, angle_x, angle_y, gain)
+            ctx.reverb_dirty = True
+            self._claim_primary()
+            serial = ctx.render_serial
+            tail_frames = self._tail_budget()[0]
+        return (yield from self._stream_started(ctx, serial, num_input_frames, tail_frames))
+
+    def stream_bank_sound(self, sound_id, gain, angle_x, angle_y, distance=1.0):
+        """Generator variant of render_bank_sound yielding stereo int16 PCM in frame_size chunks.
+
+        See _stream_started for chunking, tail and supersession behaviour.
+        """
+        num_input_frames = self._bank_frames(sound_id)
+        if num_input_frames is None:
+            return False
+        ctx = self._primary
+        with self._locked(ctx):
+            self._start_source(ctx, ctx.bank[sound_id].value, angle_x, angle_y, gain, distance)
+            ctx.reverb_dirty = True
+            self._claim_primary()
+            serial = ctx.render_serial
+            tail_frames = self._tail_budget()[0]
+        return (yield from self._stream_started(ctx, serial, num_input_frames, tail_frames))
+
+    def _stream_started(self, ctx, serial, num_input_frames, tail_frames):
+        """Yield the output of ctx's started source in frame_size chunks.
+
+        Streams always run on the primary context, and count as using it (_claim_primary)
+        until they end. Time to first chunk is one
+        frame_size render instead of the whole sound plus reverb tail. The context
+        lock is held per chunk, not across yields, so the consumer may block in
+        WavePlayer.feed() without stalling other renders. Any other render that takes
+        over the context's source ends the stream at its next chunk.
+
+        Once the input has been played, quiet tail chunks are held back; the stream
+        ends (dropping them) once the tail stays below tail_floor_dbfs for
+        tail_hold_frames, as with whole renders. The generator's return value is True
+        if the sound was rendered to completion (or silence), False if it was superseded.
+        A stream that is superseded or closed early leaves ctx's reverb marked dirty,
+        so the next sound started on ctx does not inherit its tail.
+        """
+        total_frames = num_input_frames + tail_frames
+        chunk_frames = self.frame_size
+        out_buf = (ctypes.c_int16 * (chunk_frames * 2))()
+        trimmer = self._new_trimmer()
+        # Quiet tail chunks held back until the tail either resumes or is cut
+        pending = []
+        rendered = 0
+        finished = False
+        try:
+            while rendered < total_frames:
+                frames = min(chunk_frames, total_frames - rendered)
+                with self._locked(ctx):
+                    if serial != ctx.render_serial:
+                        return False
+                    self._render_block(ctx, out_buf, frames)
+                chunk = bytes(memoryview(out_buf).cast("B")[:frames * 4])
+                chunk_start = rendered
+                rendered += frames
+                if tail_frames == 0 or rendered <= num_input_frames:
+                    yield chunk
+                    continue
+                offset = max(0, num_input_frames - chunk_start)
+                if trimmer.scan(memoryview(chunk)[offset * 4:]):
+                    self._record_tail(trimmer.quiet_start)
+                    finished = True
+                    return True
+                if trimmer.quiet_start is None or offset:
+                    yield from pending
+                    pending.clear()
+                    yield chunk
+                else:
+                    pending.append(chunk)
+            if tail_frames:
+                self._record_tail(tail_frames)
+            finished = True
+            return True
+        finally:
+            with self._locked(ctx):
+                if serial == ctx.render_serial:
+                    self.dll.alSourceStop(ctx.source.value)
+                    if finished:
+                        ctx.reverb_dirty = False
+                self._release_primary()
+
+    def stream_earcon(self, sound_id, angle_x, angle_y, volume, distance=1.0):
+        """Streaming counterpart of render_earcon: yields PCM chunks for a sound.
+
+        A render cache (or disk cache) hit yields the cached PCM as one chunk. On a miss
+        the chunks are rendered with stream_bank_sound and, if the stream ran to
+        completion, joined and stored in the caches.
+        """
+        key = self.render_key(sound_id, angle_x, angle_y, volume, distance)
+        cached = self.render_cache.get(key)
+        if cached is None:
+            cached = self._from_disk(key)
+        if cached is not None:
+            yield cached
+            return
+        _, q_x, q_y, _, _, reverb_key = key
+        chunks = []
+        stream = self.stream_bank_sound(sound_id, volume, q_x, q_y, distance)
+        while True:
+            try:
+                chunk = next(stream)
+            except StopIteration as e:
+                complete = e.value
+                break
+            chunks.append(chunk)
+            yield chunk
+        if complete and chunks and reverb_key == self._reverb_key:
+            self._store(key, b"".join(chunks))
+
+    def start_voice(self, sound_id, gain, angle_x, angle_y, distance=1.0):
+        """Start a sound bank entry on a free voice of the mixer pool, stealing the oldest if none is free.
+
+        Nothing is rendered here; the sound is heard through render_mix(). Returns
+        False if not initialized or sound_id is not loaded.
+        """
+        if self._bank_frames(sound_id) is None:
+            return False
+        ctx = self._primary
+        with self._locked(ctx):
+            index = self._free_voice()
+            self._play_on(ctx, self._voices[index], ctx.bank[sound_id].value, angle_x, angle_y, gain, distance)
+            self._voice_serial += 1
+            self._voice_started[index] = self._voice_serial
+            # The pool's tail carries on by design; anything else started here clears it
+            ctx.reverb_dirty = True
+            if not self._pool_claimed:
+                self._pool_claimed = True
+                self._claim_primary()
+        return True
+
+    @property
+    def voice_serial(self):
+        """Count of start_voice() calls so far; see voices_settled()."""
+        return self._voice_serial
+
+    def voices_settled(self, serial=None):
+        """Called by the mixer once the voice pool and its tail have gone silent.
+
+        One-shot renders may use the primary context again until the next start_voice().
+        serial is the voice_serial read before the block judged silent; if a voice
+        has started since, the pool keeps the primary. None releases it regardless.
+        """
+        if self.dll is None or not self.initialized:
+            return
+        with self._locked(self._primary):
+            if serial is not None and serial != self._voice_serial:
+                return
+            if self._pool_claimed:
+                self._pool_claimed = False
+                self._release_primary()
+
+    def _free_voice(self):
+        """Return the index of a stopped voice, or of the oldest one. Caller must hold the primary lock."""
+        state = ctypes.c_int(0)
+        for index, voice in enumerate(self._voices):
+            self.dll.alGetSourcei(voice, AL_SOURCE_STATE, ctypes.byref(state))
+            if state.value != AL_PLAYING:
+                return index
+        return min(range(len(self._voices)), key=self._voice_started.__getitem__)
+
+    def stop_voices(self):
+        """Stop every voice in the mixer pool; reverb already in the effect slot keeps decaying."""
+        if self.dll is None or not self.initialized:
+            return
+        with self._locked(self._primary):
+            for voice in self._voices:
+                self.dll.alSourceStop(voice)
+
+    def render_mix(self, out_buf, num_frames):
+        """Render num_frames of everything playing on the voice pool into out_buf.
+
+        out_buf is a ctypes int16 array of at least num_frames * 2 samples. Returns
+        True if any voice is still playing afterwards, False if only the reverb tail
+        (or silence) remains. The voices live on the primary context; a one-shot render
+        there would advance them too, which is why _render_context keeps one-shots off
+        the primary from start_voice() until voices_settled().
+        """
+        state = ctypes.c_int(0)
+        with self._locked(self._primary):
+            self._render_block(self._primary, out_buf, num_frames)
+            for voice in self._voices:
+                self.dll.alGetSourcei(voice, AL_SOURCE_STATE, ctypes.byref(state))
+                if state.value == AL_PLAYING:
+                    return True
+            return False
 
     def apply_reverb(self, input_buffer):
         """Return input_buffer unchanged.
-        Reverb is applied inside process_sound via EFX effect slot.
+        Reverb is applied inside process_sound via the EFX effect slot or the classic reverb.
         Callers that invoke apply_reverb separately receive unmodified audio."""
         return input_buffer
 
 
 # Module-level singleton -- one OpenALLoopback instance shared across all threads
 _openal_audio_instance = None
+# The plugin creates the instance on its init thread while the settings panel
+# may ask for it on the main thread
+_openal_audio_instance_lock = threading.Lock()
 
 
 def get_openal_audio():
     """Return the global OpenALLoopback singleton, creating it on first call."""
     global _openal_audio_instance
-    if _openal_audio_instance is None:
-        _openal_audio_instance = OpenALLoopback()
-    return _openal_audio_instance
+    with _openal_audio_instance_lock:
+        if _openal_audio_instance is None:
+            _openal_audio_instance = OpenALLoopback()
+        return _openal_audio_instance
 
 
-def initialize_openal_audio(sample_rate=44100, frame_size=1024):
+def initialize_openal_audio(sample_rate=DEFAULT_SAMPLE_RATE, frame_size=1024):
     """Initialize the global OpenALLoopback instance."""
     return get_openal_audio().initialize(sample_rate, frame_size)
 
@@ -0,0 +1,163 @@
+"""
+Whole-buffer PCM conversion kernels.
+
+The sample loops the engine needs outside OpenAL work on contiguous buffers
+rather than Python lists: float to int16 conversion, picking one channel out
+of interleaved frames, resampling the sound bank once at load, and block
+energies for the tail trimmer. Gain is left to AL_GAIN. Each uses the fastest
+implementation available:
+
+    numpy    if it can be imported (NVDA does not ship it; an add-on may)
+    audioop  C kernels from the standard library (Python 3.12 and older)
+    array    plain Python over array.array, the original code paths
+
+int16 results are ctypes arrays, which OpenAL's alBufferData and the native
+spatializer take directly. BACKEND names the implementation in use.
+"""
+
+import array
+import ctypes
+import math
+import operator
+import sys
+import warnings
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+try:
+    with warnings.catch_warnings():
+        # Deprecated since Python 3.11
+        warnings.simplefilter("ignore", DeprecationWarning)
+        import audioop
+except ImportError:
+    audioop = None
+
+if numpy is not None:
+    BACKEND = "numpy"
+elif audioop is not None:
+    BACKEND = "audioop"
+else:
+    BACKEND = "array"
+
+# math.sumprod (Python 3.12+) computes a sum of squares at C speed.
+_sumprod = getattr(math, "sumprod", None)
+
+_BIG_ENDIAN = sys.byteorder == "big"
+
+
+def _int16_array_from(values):
+    """ctypes int16 array holding a numpy int16 array's samples."""
+    out = (ctypes.c_int16 * len(values))()
+    numpy.frombuffer(out, dtype=numpy.int16)[:] = values
+    return out
+
+
+def float_to_int16(samples):
+    """Convert float samples in [-1, 1] (any sequence or float32 buffer) to a ctypes int16 array."""
+    if numpy is not None:
+        if isinstance(samples, (bytes, bytearray, memoryview)):
+            # Raw float32 PCM
+            values = numpy.frombuffer(samples, dtype=numpy.float32)
+        else:
+            values = numpy.asarray(samples, dtype=numpy.float32)
+        return _int16_array_from((numpy.clip(values, -1.0, 1.0) * 32767.0).astype(numpy.int16))
+    if isinstance(samples, (bytes, bytearray, memoryview)):
+        # Raw float32 PCM; iterating the bytes would yield integers
+        values = array.array("f")
+        values.frombytes(samples)
+        samples = values
+    n = len(samples)
+    out = (ctypes.c_int16 * n)()
+    out[:] = [int(max(-1.0, min(1.0, s)) * 32767) for s in samples]
+    return out
+
+
+def first_channel(frames, channels):
+    """Return the first channel of interleaved int16 frames as native-endian bytes.
+
+    Wav data is little endian; it is byteswapped on big-endian hosts.
+    """
+    if channels == 1 and not _BIG_ENDIAN:
+        return bytes(frames)
+    if numpy is not None:
+        values = numpy.frombuffer(frames, dtype="<i2")[::channels]
+        return values.astype(numpy.int16).tobytes()
+    if audioop is not None and channels == 2 and not _BIG_ENDIAN:
+        return audioop.tomono(frames, 2, 1.0, 0.0)
+    samples = array.array("h")
+    samples.frombytes(frames)
+    if _BIG_ENDIAN:
+        samples.byteswap()
+    return samples[::channels].tobytes()
+
+
+def resample_int16(pcm, src_rate, dst_rate):
+    """Resample mono native-endian int16 PCM bytes from src_rate to dst_rate by linear interpolation.
+
+    Used once per sound at load time; returns ceil(n * dst_rate / src_rate) samples
+    (give or take one with audioop) as bytes.
+    """
+    if src_rate == dst_rate:
+        return bytes(pcm)
+    n = len(pcm) // 2
+    n_out = -(-n * dst_rate // src_rate)
+    if numpy is not None:
+        values = numpy.frombuffer(pcm, dtype=numpy.int16).astype(numpy.float64)
+        positions = numpy.arange(n_out) * (src_rate / dst_rate)
+        out = numpy.interp(positions, numpy.arange(n), values)
+        return numpy.clip(numpy.rint(out), -32768, 32767).astype(numpy.int16).tobytes()
+    if audioop is not None:
+        return audioop.ratecv(bytes(pcm), 2, 1, src_rate, dst_rate, None)[0]
+    samples = array.array("h")
+    samples.frombytes(pcm)
+    out = array.array("h", bytes(2 * n_out))
+    step = src_rate / dst_rate
+    last = n - 1
+    for i in range(n_out):
+        position = i * step
+        index = int(position)
+        if index >= last:
+            out[i] = samples[last]
+            continue
+        frac = position - index
+        out[i] = int(round(samples[index] + (samples[index + 1] - samples[index]) * frac))
+    return out.tobytes()
+
+
+def _sum_squares(samples):
+    if _sumprod is not None:
+        return _sumprod(samples, samples)
+    return sum(map(operator.mul, samples, samples))
+
+
+def block_energies(pcm, block_samples):
+    """Yield (sum of squares, sample count) for consecutive block_samples blocks of int16 PCM."""
+    if numpy is not None:
+        values = numpy.frombuffer(memoryview(pcm).cast("B"), dtype=numpy.int16).astype(numpy.float64)
+        full = len(values) // block_samples * block_samples
+        if full:
+            blocks = values[:full].reshape(-1, block_samples)
+            yield from zip(numpy.einsum("ij,ij->i", blocks, blocks).tolist(), [block_samples] * len(blocks))
+        if full < len(values):
+            rest = values[full:]
+            yield float(numpy.dot(rest, rest)), len(rest)
+        return
+    if audioop is not None:
+        data = bytes(memoryview(pcm).cast("B"))
+        step = block_samples * 2
+        for offset in range(0, len(data), step):
+            block = data[offset:offset + step]
+            count = len(block) // 2
+            # rms() is sqrt(sum of squares / count) truncated to an int, which
+            # under-reads by less than one quantization step
+            rms = audioop.rms(block, 2)
+            yield rms * rms * count, count
+        return
+    samples = array.array("h")
+    samples.frombytes(pcm)
+    for offset in range(0, len(samples), block_samples):
+        block = samples[offset:offset + block_samples]
+        yield _sum_squares(block), len(block)
@@ -0,0 +1,196 @@
+"""
+Background render cache pre-warming.
+
+After initialize() and whenever the engine's reverb key changes (which clears
+the render cache), a low-priority thread renders the most common earcons into
+the cache so the first pass through a new screen is served from it. The job
+list holds, in order:
+
+    1. the cells most recently requested by live sounds, newest first, at the
+       distance they were played at; their renders were just thrown away by the
+       settings change
+    2. a grid of quantized azimuths across the display for each common sound,
+       centre first, at the elevations of typical screen rows, at unit distance
+
+Cells are rendered batch_size at a time through OpenALLoopback.warm_batch(),
+one render context lock and (with spatializer.dll) one native call per batch.
+The job yields to live sounds: it waits until no sound has been requested for
+idle_delay seconds before every batch. Batches only run on the engine's secondary
+loopback contexts, waiting for one if a live render holds it, so they never cut
+into a stream or the mixer on the primary; the plugin does not pre-warm at all
+when the engine has only the primary context. cpu_budget is the fraction of one
+core it may use (it sleeps between batches to stay under it), and max_bytes
+caps how many bytes of renders one job adds to the render cache.
+"""
+
+import threading
+import time
+from collections import OrderedDict
+
+from .render_cache import CACHE_ANGLE_STEP, quantize_angle
+
+try:
+    from logHandler import log
+except ImportError:
+    import logging as log
+
+# Azimuths are warmed every this many degrees; a multiple of the cache grid so
+# each warmed render is an exact cache cell.
+DEFAULT_AZIMUTH_STEP = 3 * CACHE_ANGLE_STEP
+
+# Elevations (degrees) of the rows warmed for every azimuth: middle, upper and
+# lower screen bands of the add-on's -40..10 degree display.
+DEFAULT_ELEVATIONS = (-15.0, 0.0, -30.0)
+
+# Recently played cells remembered for re-warming after a settings change.
+DEFAULT_RECENT_CELLS = 64
+
+# Cells rendered per warm_batch() call: small enough that a batch holds its
+# render context for only a few tens of milliseconds.
+DEFAULT_BATCH_SIZE = 4
+
+
+class CachePrewarmer:
+    """Low-priority thread filling an OpenALLoopback render cache.
+
+    sound_ids are ordered most common first. volume() returns the volume live
+    sounds are currently rendered at, so warmed entries match their cache keys.
+    """
+
+    def __init__(self, engine, sound_ids, volume, cpu_budget=0.25, max_bytes=8 * 1024 * 1024,
+                 idle_delay=0.5, azimuth_step=DEFAULT_AZIMUTH_STEP, elevations=DEFAULT_ELEVATIONS,
+                 recent_cells=DEFAULT_RECENT_CELLS, batch_size=DEFAULT_BATCH_SIZE, name="UnspokenPrewarm"):
+        self._engine = engine
+        self._sound_ids = list(sound_ids)
+        self._volume = volume
+        self.cpu_budget = cpu_budget
+        self.max_bytes = max_bytes
+        self.idle_delay = idle_delay
+        self.azimuth_step = azimuth_step
+        self.elevations = tuple(elevations)
+        self._recent = OrderedDict()
+        self._recent_cells = recent_cells
+        self.batch_size = max(1, batch_size)
+        self._cond = threading.Condition()
+        self._running = True
+        # Bumped by restart(); a job in progress stops when it no longer matches
+        self._generation = 0
+        self._last_activity = 0.0
+        self.rendered = 0
+        self._thread = threading.Thread(target=self._run, name=name, daemon=True)
+        self._thread.start()
+
+    def restart(self):
+        """(Re)start the job from the top, e.g. after the render cache was cleared.
+
+        Counts as activity, so a burst of settings changes (a slider being dragged)
+        only warms once it settles.
+        """
+        self._last_activity = time.perf_counter()
+        with self._cond:
+            self._generation += 1
+            self._cond.notify()
+
+    def note_activity(self, sound_id=None, angle_x=None, angle_y=None, distance=1.0):
+        """Record a live sound request; the job pauses until requests stop for idle_delay.
+
+        With a position, the cell (and the distance, which is part of its render
+        cache key) is remembered for re-warming after settings changes.
+        """
+        self._last_activity = time.perf_counter()
+        if sound_id is None:
+            return
+        cell = (sound_id, quantize_angle(angle_x), quantize_angle(angle_y), distance)
+        with self._cond:
+            self._recent.pop(cell, None)
+            self._recent[cell] = None
+            while len(self._recent) > self._recent_cells:
+                self._recent.popitem(last=False)
+
+    def stop(self, timeout=1.0):
+        with self._cond:
+            self._running = False
+            self._cond.notify()
+        if self._thread is not threading.current_thread():
+            self._thread.join(timeout)
+
+    def _jobs(self):
+        """Yield (sound_id, angle_x, angle_y, distance) in warming order."""
+        with self._cond:
+            recent = list(reversed(self._recent))
+        yield from recent
+        # Centre outwards: 0, +step, -step, +2*step, ...
+        azimuths = [0.0]
+        angle = self.azimuth_step
+        while angle <= 90.0:
+            azimuths += [angle, -angle]
+            angle += self.azimuth_step
+        for sound_id in self._sound_ids:
+            for angle_y in self.elevations:
+                for angle_x in azimuths:
+                    yield sound_id, angle_x, angle_y, 1.0
+
+    def _run(self):
+        seen = 0
+        while True:
+            with self._cond:
+                while self._generation == seen and self._running:
+                    self._cond.wait()
+                if not self._running:
+                    return
+                seen = self._generation
+            try:
+                self._warm(seen)
+            except Exception:
+                log.error("Unspoken cache pre-warm failed", exc_info=True)
+
+    def _current(self, generation):
+        return self._running and generation == self._generation
+
+    def _wait_idle(self, generation):
+        """Sleep until no live sound was requested for idle_delay. Returns False if superseded."""
+        while self._current(generation):
+            quiet = time.perf_counter() - self._last_activity
+            if quiet >= self.idle_delay:
+                return True
+            with self._cond:
+                self._cond.wait(self.idle_delay - quiet)
+        return False
+
+    def _batches(self):
+        """Yield lists of up to batch_size cells from _jobs()."""
+        batch = []
+        for cell in self._jobs():
+            batch.append(cell)
+            if len(batch) >= self.batch_size:
+                yield batch
+                batch = []
+        if batch:
+            yield batch
+
+    def _warm(self, generation):
+        engine = self._engine
+        warmed_bytes = 0
+        rendered = 0
+        started = time.perf_counter()
+        for cells in self._batches():
+            if warmed_bytes >= self.max_bytes or not self._wait_idle(generation):
+                break
+            render_start = time.perf_counter()
+            added = [size for size in engine.warm_batch(cells, self._volume()) if size]
+            if not added:
+                continue
+            warmed_bytes += sum(added)
+            rendered += len(added)
+            self.rendered += len(added)
+            # Sleep long enough that rendering stays within cpu_budget of one core
+            spent = time.perf_counter() - render_start
+            if 0.0 < self.cpu_budget < 1.0:
+                with self._cond:
+                    if self._current(generation):
+                        self._cond.wait(spent * (1.0 - self.cpu_budget) / self.cpu_budget)
+        if self._current(generation):
+            log.debug(
+                f"Unspoken cache pre-warm rendered {rendered} earcons ({warmed_bytes} bytes) in "
+                f"{time.perf_counter() - started:.1f}s"
+            )
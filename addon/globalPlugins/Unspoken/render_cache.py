@@ -0,0 +1,110 @@
+"""
+LRU cache of rendered earcons for the OpenAL loopback engine.
+
+Only ~16 wav files are bundled and sound positions fall in a bounded angle
+range, so once angles are quantized the set of distinct renders is small.
+Entries hold the finished stereo int16 PCM bytes exactly as handed to
+nvwave.WavePlayer.feed(); a hit skips buffer upload, source setup and
+alcRenderSamplesSOFT entirely, and never touches _openal_audio_mutex.
+
+Keys are built by the engine (see OpenALLoopback.render_key) and include a
+reverb-settings key, so entries rendered under old settings can never be
+returned. The engine still clears the cache on every settings change to give
+the memory back.
+"""
+
+import threading
+from collections import OrderedDict
+
+# Angles are snapped to this grid (degrees) before rendering and lookup.
+# 3 degrees is below the localization blur of generic HRTFs for frontal sources.
+CACHE_ANGLE_STEP = 3.0
+
+# Default memory ceiling for cached PCM. A 10% room-size render is ~170 KB.
+DEFAULT_MAX_BYTES = 32 * 1024 * 1024
+
+
+def quantize_angle(angle, step=CACHE_ANGLE_STEP):
+    """Snap an angle in degrees to the nearest multiple of step."""
+    return round(angle / step) * step
+
+
+class RenderCache:
+    """Thread-safe LRU mapping of render keys to stereo PCM bytes, bounded by total size.
+
+    Counters (hits, misses, evictions) are cumulative across clear() so they can be
+    used to size max_bytes; reset_stats() zeroes them.
+    """
+
+    def __init__(self, max_bytes=DEFAULT_MAX_BYTES):
+        self.max_bytes = max_bytes
+        self._entries = OrderedDict()
+        self._lock = threading.Lock()
+        self._bytes = 0
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __contains__(self, key):
+        """Membership test that does not count as a lookup or refresh recency."""
+        with self._lock:
+            return key in self._entries
+
+    def get(self, key):
+        """Return cached PCM for key (marking it most recently used), or None."""
+        with self._lock:
+            pcm = self._entries.get(key)
+            if pcm is None:
+                self.misses += 1
+                return None
+            self._entries.move_to_end(key)
+            self.hits += 1
+            return pcm
+
+    def put(self, key, pcm):
+        """Insert pcm under key, evicting least recently used entries to stay within max_bytes.
+
+        Buffers larger than max_bytes on their own are not cached.
+        """
+        size = len(pcm)
+        if size > self.max_bytes:
+            return
+        with self._lock:
+            old = self._entries.pop(key, None)
+            if old is not None:
+                self._bytes -= len(old)
+            self._entries[key] = pcm
+            self._bytes += size
+            while self._bytes > self.max_bytes:
+                _, evicted = self._entries.popitem(last=False)
+                self._bytes -= len(evicted)
+                self.evictions += 1
+
+    def clear(self):
+        """Drop all entries; counters are preserved."""
+        with self._lock:
+            self._entries.clear()
+            self._bytes = 0
+
+    def reset_stats(self):
+        with self._lock:
+            self.hits = 0
+            self.misses = 0
+            self.evictions = 0
+
+    def get_stats(self):
+        """Return a snapshot dict of entry count, resident bytes and hit/miss/eviction counters."""
+        with self._lock:
+            lookups = self.hits + self.misses
+            return {
+                "entries": len(self._entries),
+                "bytes": self._bytes,
+                "max_bytes": self.max_bytes,
+                "hits": self.hits,
+                "misses": self.misses,
+                "evictions": self.evictions,
+                "hit_rate": (self.hits / lookups) if lookups else 0.0,
+            }
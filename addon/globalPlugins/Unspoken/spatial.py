@@ -0,0 +1,168 @@
+"""
+Precomputed mapping from screen positions to OpenAL source positions.
+
+A sound is only ever heard to within the render cache's CACHE_ANGLE_STEP grid,
+so both halves of the mapping are tables built ahead of time:
+
+  ScreenMap      rebuilt whenever the monitor layout changes (geometry.py);
+                 turns an object's screen rectangle into a grid cell (angle_x,
+                 angle_y, distance) with a few list lookups on NVDA's main thread.
+  PositionTable  the sine and cosine of every grid angle, computed once, from
+                 which the engine forms the AL position vector of a cell
+                 without any trigonometry per sound.
+
+The cell is also what the render cache keys on (OpenALLoopback.render_key), so
+an event's position and its cache entry agree by construction.
+
+Optionally the object's size is encoded as distance: a pane that covers much of
+its monitor sounds farther away, and so quieter under OpenAL's inverse distance
+model, than a button.
+"""
+
+import math
+
+from .render_cache import CACHE_ANGLE_STEP, quantize_angle
+
+# Screen pixels per ScreenMap cell; well under one CACHE_ANGLE_STEP on any desktop.
+SCREEN_CELL_PIXELS = 8
+
+# (share of the monitor's area, source distance) pairs, largest share first. An
+# object covering at least the share is placed at the distance; smaller objects
+# stay on the unit sphere. OpenAL's reference distance is 1, so 2.0 is 6 dB down.
+SIZE_DISTANCES = ((0.25, 2.0), (0.05, 1.4))
+
+
+def _clamp(value, lowest, highest):
+    return max(lowest, min(highest, value))
+
+
+def direction(angle_x, angle_y):
+    """Unit direction vector for azimuth/elevation in degrees (listener faces -z)."""
+    rad_x = math.radians(angle_x)
+    rad_y = math.radians(angle_y)
+    return (
+        math.sin(rad_x) * math.cos(rad_y),
+        math.sin(rad_y),
+        -math.cos(rad_x) * math.cos(rad_y),
+    )
+
+
+class PositionTable:
+    """AL source positions for every cell of the angle grid.
+
+    The direction vector is separable into per-axis sines and cosines, so the
+    table holds two short lists and a lookup is four multiplications.
+    """
+
+    def __init__(self, step=CACHE_ANGLE_STEP):
+        self.step = step
+        self._offset = int(round(90.0 / step))
+        angles = [i * step for i in range(-self._offset, self._offset + 1)]
+        self._sin = [math.sin(math.radians(angle)) for angle in angles]
+        self._cos = [math.cos(math.radians(angle)) for angle in angles]
+
+    def _index(self, angle):
+        """List index of a grid angle, or None for an angle off the grid."""
+        cell = round(angle / self.step)
+        if cell * self.step != angle or abs(cell) > self._offset:
+            return None
+        return cell + self._offset
+
+    def position(self, angle_x, angle_y, distance=1.0):
+        """Return the AL position for angles in degrees, distance units from the listener.
+
+        Raw degree values would place the source far from the listener, causing
+        near-silence from OpenAL's distance attenuation model, so the position is a
+        direction vector scaled by distance. Off-grid angles (process_sound and
+        process_pcm16 callers) are computed directly.
+        """
+        i = self._index(angle_x)
+        j = self._index(angle_y)
+        if i is None or j is None:
+            x, y, z = direction(angle_x, angle_y)
+            return (x * distance, y * distance, z * distance)
+        cos_y = self._cos[j] * distance
+        return (self._sin[i] * cos_y, self._sin[j] * distance, -self._cos[i] * cos_y)
+
+
+class ScreenMap:
+    """Screen rectangle to grid cell mapping for one monitor layout.
+
+    azimuth_span is the width of the audio display in degrees, centred ahead and
+    stretched across the whole virtual desktop, so the leftmost monitor is on the
+    left. Elevation follows the monitor an object is on: its bottom edge is at
+    elevation_min and its top edge elevation_span degrees above.
+    """
+
+    def __init__(self, azimuth_span=180.0, elevation_min=-40.0, elevation_span=50.0):
+        self.azimuth_span = azimuth_span
+        self.elevation_min = elevation_min
+        self.elevation_span = elevation_span
+        self.monitors = ()
+        self._centre = (0.0, quantize_angle(elevation_min + elevation_span / 2.0))
+        self._left = 0
+        self._columns = [self._centre[0]]
+        # Per column cell, (top, bottom, rows, area) of each monitor spanning it, by top
+        self._column_monitors = [((0, 1, [self._centre[1]], 1.0),)]
+
+    def set_monitors(self, monitors):
+        """Rebuild the tables for (left, top, width, height) monitor rectangles.
+
+        A no-op if the layout is unchanged.
+        """
+        monitors = tuple(m for m in monitors if m[2] > 0 and m[3] > 0)
+        if not monitors or monitors == self.monitors:
+            return
+        self.monitors = monitors
+        left = min(m[0] for m in monitors)
+        width = max(m[0] + m[2] for m in monitors) - left
+        self._left = left
+        half = SCREEN_CELL_PIXELS / 2.0
+        self._columns = [
+            quantize_angle(_clamp(((x + half - width / 2.0) / width) * self.azimuth_span, -90.0, 90.0))
+            for x in range(0, width, SCREEN_CELL_PIXELS)
+        ]
+        entries = []
+        for m_left, m_top, m_width, m_height in monitors:
+            rows = [
+                quantize_angle(_clamp(self.elevation_span * (m_height - y - half) / m_height
+                                      + self.elevation_min, -90.0, 90.0))
+                for y in range(0, m_height, SCREEN_CELL_PIXELS)
+            ]
+            entries.append((m_left - left, m_left - left + m_width,
+                            (m_top, m_top + m_height, rows, float(m_width * m_height))))
+        self._column_monitors = []
+        for column in range(len(self._columns)):
+            x = column * SCREEN_CELL_PIXELS + half
+            spanning = [entry for start, end, entry in entries if start <= x < end]
+            if not spanning:
+                # A gap between monitors of different sizes; use the nearest one
+                nearest = min(entries, key=lambda e: min(abs(x - e[0]), abs(x - e[1])))
+                spanning = [nearest[2]]
+            self._column_monitors.append(tuple(sorted(spanning, key=lambda entry: entry[0])))
+
+    def locate(self, location, size_as_distance=False):
+        """Return (angle_x, angle_y, distance) for a (left, top, width, height) rectangle.
+
+        None (no location) is placed at the centre of the display. Objects partly
+        off screen take the cell of the nearest edge.
+        """
+        if location is None:
+            return self._centre + (1.0,)
+        left, top, width, height = location
+        column = _clamp(int(left + width / 2.0 - self._left) // SCREEN_CELL_PIXELS, 0, len(self._columns) - 1)
+        y = top + height / 2.0
+        # At most a few monitors are stacked in any column
+        for monitor in self._column_monitors[column]:
+            if y < monitor[1]:
+                break
+        m_top, _, rows, area = monitor
+        row = _clamp(int(y - m_top) // SCREEN_CELL_PIXELS, 0, len(rows) - 1)
+        distance = 1.0
+        if size_as_distance:
+            share = (width * height) / area
+            for threshold, level in SIZE_DISTANCES:
+                if share >= threshold:
+                    distance = level
+                    break
+        return (self._columns[column], rows[row], distance)
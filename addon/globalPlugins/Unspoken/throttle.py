@@ -0,0 +1,88 @@
+"""
+Per-event-source rate limiting for NVDA events that trigger sounds.
+
+Each source (mouse, navigator, focus) gets an EventThrottle on the main
+thread, in front of the COM property reads of _extract_sound_params. Objects
+are coalesced rather than dropped, so the last object of a burst is always
+the one that plays:
+
+    interval  minimum time between the onsets of two sounds. An object that
+              arrives sooner waits until the interval has passed; if others
+              arrive meanwhile, only the newest of them plays.
+    settle    play only once no new object has arrived for interval ("final
+              object after motion settles"): sweeping over a toolbar plays just
+              the button the pointer stops on.
+
+An interval of 0 passes every object straight through. Delayed objects are
+played from a one-shot main-thread timer created by schedule(delay_ms, fn),
+normally wx.CallLater, which must return an object with Stop().
+"""
+
+import time
+
+# Nothing held; None is a valid object to submit
+_NOTHING = object()
+
+
+class EventThrottle:
+    """Minimum inter-onset interval with trailing-edge coalescing for one event source."""
+
+    def __init__(self, play, schedule, interval=0.0, settle=False):
+        self._play = play
+        self._schedule = schedule
+        self.interval = interval
+        self.settle = settle
+        self._last_onset = 0.0
+        self._pending = _NOTHING
+        self._timer = None
+        # Objects coalesced away instead of being extracted and rendered
+        self.dropped = 0
+        self.played = 0
+
+    def configure(self, interval, settle):
+        self.interval = interval
+        self.settle = settle
+
+    def submit(self, obj):
+        """Play obj now, or hold it until the interval allows (see module docstring)."""
+        interval = self.interval
+        if interval <= 0.0:
+            self._fire(obj)
+            return
+        now = time.perf_counter()
+        if self._pending is not _NOTHING:
+            self.dropped += 1
+        if self.settle:
+            self._pending = obj
+            self._restart_timer(interval)
+            return
+        wait = self._last_onset + interval - now
+        if wait <= 0.0 and self._timer is None:
+            self._fire(obj)
+            return
+        self._pending = obj
+        if self._timer is None:
+            self._restart_timer(max(0.0, wait))
+
+    def cancel(self):
+        """Forget any held object; called on terminate."""
+        if self._timer is not None:
+            self._timer.Stop()
+            self._timer = None
+        self._pending = _NOTHING
+
+    def _restart_timer(self, delay):
+        if self._timer is not None:
+            self._timer.Stop()
+        self._timer = self._schedule(max(1, int(delay * 1000.0 + 0.5)), self._on_timer)
+
+    def _on_timer(self):
+        self._timer = None
+        obj, self._pending = self._pending, _NOTHING
+        if obj is not _NOTHING:
+            self._fire(obj)
+
+    def _fire(self, obj):
+        self._last_onset = time.perf_counter()
+        self.played += 1
+        self._play(obj)
@@ -0,0 +1,274 @@
+// Block-based classic reverb (see reverb.h).
+//
+// verblib called verblib_comb_process and verblib_allpass_process once per
+// sample per filter: 24 calls for every output frame. Here each output block
+// makes one pass over the comb bank and one per allpass stage:
+//
+//   combs     The 16 combs (8 per channel) run in lockstep as the lanes of a
+//             structure-of-arrays bank. Their delay lines share one ring buffer
+//             of 16-float rows, so the per-sample write of all combs is a single
+//             contiguous row; lane k reads the row comb_delay[k] samples back.
+//             The damping filters are an IIR in time, so time stays the outer loop
+//             and the arithmetic across lanes is what the compiler vectorizes.
+//   allpasses Each stage is applied to the whole block before the next. A slot is
+//             read and rewritten once per pass through its delay line, so runs up
+//             to the wrap point carry no dependency between samples and vectorize
+//             across time.
+//
+// Build: compiled into spatializer.dll with spatializer.cpp.
+
+#include "reverb.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define REVERB_HAVE_MXCSR 1
+#endif
+
+// verblib constants; tunings are delay lengths in samples at 44.1 kHz.
+static const int NUM_COMBS = 8;
+static const int NUM_ALLPASSES = 4;
+static const int COMB_LANES = NUM_COMBS * 2;
+static const float FIXED_GAIN = 0.015f;
+static const float SCALE_WET = 3.0f;
+static const float SCALE_DRY = 2.0f;
+static const float SCALE_DAMP = 0.4f;
+static const float SCALE_ROOM = 0.28f;
+static const float OFFSET_ROOM = 0.7f;
+static const float ALLPASS_FEEDBACK = 0.5f;
+static const int STEREO_SPREAD = 23;
+static const int COMB_TUNING[NUM_COMBS] = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+static const int ALLPASS_TUNING[NUM_ALLPASSES] = {556, 441, 341, 225};
+
+// Frames per block; bounds the stack scratch buffers in reverb_process_int16.
+static const int BLOCK_FRAMES = 256;
+
+struct Reverb {
+	// Comb bank: lanes 0-7 feed the left channel, 8-15 the right
+	float* comb_ring;          // comb_rows rows of COMB_LANES floats
+	int comb_rows;             // power of two greater than the longest comb delay
+	int comb_pos;              // row written by the next sample
+	int comb_delay[COMB_LANES];
+	float comb_store[COMB_LANES];  // damping lowpass state
+	float feedback;
+	float damp1;
+	float damp2;
+
+	// Allpass stages, in series per channel
+	float* allpass_buf[2][NUM_ALLPASSES];
+	int allpass_len[2][NUM_ALLPASSES];
+	int allpass_idx[2][NUM_ALLPASSES];
+
+	float wet1;
+	float wet2;
+	float dry;
+
+	// Owns comb_ring and every allpass_buf
+	float* storage;
+	size_t storage_floats;
+};
+
+static int scaled_delay(int tuning, int sample_rate) {
+	int delay = static_cast<int>(static_cast<long long>(tuning) * sample_rate / 44100);
+	return delay > 0 ? delay : 1;
+}
+
+SPATIALIZER_EXPORT Reverb* reverb_create(int sample_rate) {
+	if (sample_rate <= 0) {
+		return nullptr;
+	}
+	Reverb* reverb = new (std::nothrow) Reverb();
+	if (!reverb) {
+		return nullptr;
+	}
+	int longest = 0;
+	for (int i = 0; i < NUM_COMBS; ++i) {
+		reverb->comb_delay[i] = scaled_delay(COMB_TUNING[i], sample_rate);
+		reverb->comb_delay[NUM_COMBS + i] = scaled_delay(COMB_TUNING[i] + STEREO_SPREAD, sample_rate);
+		if (reverb->comb_delay[NUM_COMBS + i] > longest) {
+			longest = reverb->comb_delay[NUM_COMBS + i];
+		}
+	}
+	reverb->comb_rows = 1;
+	while (reverb->comb_rows <= longest) {
+		reverb->comb_rows <<= 1;
+	}
+	size_t floats = static_cast<size_t>(reverb->comb_rows) * COMB_LANES;
+	for (int channel = 0; channel < 2; ++channel) {
+		for (int i = 0; i < NUM_ALLPASSES; ++i) {
+			int len = scaled_delay(ALLPASS_TUNING[i] + channel * STEREO_SPREAD, sample_rate);
+			reverb->allpass_len[channel][i] = len;
+			floats += len;
+		}
+	}
+	reverb->storage = static_cast<float*>(std::calloc(floats, sizeof(float)));
+	if (!reverb->storage) {
+		delete reverb;
+		return nullptr;
+	}
+	reverb->storage_floats = floats;
+	reverb->comb_ring = reverb->storage;
+	float* next = reverb->storage + static_cast<size_t>(reverb->comb_rows) * COMB_LANES;
+	for (int channel = 0; channel < 2; ++channel) {
+		for (int i = 0; i < NUM_ALLPASSES; ++i) {
+			reverb->allpass_buf[channel][i] = next;
+			next += reverb->allpass_len[channel][i];
+		}
+	}
+	// verblib's initial values
+	reverb_set_params(reverb, 0.5f, 0.5f, 1.0f / SCALE_WET, 0.0f, 1.0f);
+	return reverb;
+}
+
+SPATIALIZER_EXPORT void reverb_destroy(Reverb* reverb) {
+	if (reverb) {
+		std::free(reverb->storage);
+		delete reverb;
+	}
+}
+
+SPATIALIZER_EXPORT void reverb_set_params(Reverb* reverb, float room_size, float damping, float wet,
+	float dry, float width) {
+	if (!reverb) {
+		return;
+	}
+	reverb->feedback = room_size * SCALE_ROOM + OFFSET_ROOM;
+	reverb->damp1 = damping * SCALE_DAMP;
+	reverb->damp2 = 1.0f - reverb->damp1;
+	const float scaled_wet = wet * SCALE_WET;
+	reverb->wet1 = scaled_wet * (width / 2.0f + 0.5f);
+	reverb->wet2 = scaled_wet * ((1.0f - width) / 2.0f);
+	reverb->dry = dry * SCALE_DRY;
+}
+
+SPATIALIZER_EXPORT size_t reverb_memory_bytes(const Reverb* reverb) {
+	if (!reverb) {
+		return 0;
+	}
+	return sizeof(Reverb) + reverb->storage_floats * sizeof(float);
+}
+
+SPATIALIZER_EXPORT void reverb_reset(Reverb* reverb) {
+	if (!reverb) {
+		return;
+	}
+	std::memset(reverb->storage, 0, reverb->storage_floats * sizeof(float));
+	std::memset(reverb->comb_store, 0, sizeof(reverb->comb_store));
+	reverb->comb_pos = 0;
+	std::memset(reverb->allpass_idx, 0, sizeof(reverb->allpass_idx));
+}
+
+// Run the comb bank over n mono input samples, summing lanes into left and right.
+static void comb_block(Reverb* reverb, const float* input, int n, float* left, float* right) {
+	const int mask = reverb->comb_rows * COMB_LANES - 1;
+	float* ring = reverb->comb_ring;
+	const float feedback = reverb->feedback;
+	const float damp1 = reverb->damp1;
+	const float damp2 = reverb->damp2;
+	float store[COMB_LANES];
+	int read[COMB_LANES];
+	const int write = reverb->comb_pos * COMB_LANES;
+	for (int k = 0; k < COMB_LANES; ++k) {
+		store[k] = reverb->comb_store[k];
+		read[k] = (write - reverb->comb_delay[k] * COMB_LANES + k) & mask;
+	}
+	for (int i = 0; i < n; ++i) {
+		const int step = i * COMB_LANES;
+		float out[COMB_LANES];
+		for (int k = 0; k < COMB_LANES; ++k) {
+			out[k] = ring[(read[k] + step) & mask];
+		}
+		float* row = ring + ((write + step) & mask);
+		const float x = input[i];
+		for (int k = 0; k < COMB_LANES; ++k) {
+			store[k] = out[k] * damp2 + store[k] * damp1;
+			row[k] = x + store[k] * feedback;
+		}
+		float sum_left = 0.0f;
+		float sum_right = 0.0f;
+		for (int k = 0; k < NUM_COMBS; ++k) {
+			sum_left += out[k];
+			sum_right += out[NUM_COMBS + k];
+		}
+		left[i] = sum_left;
+		right[i] = sum_right;
+	}
+	for (int k = 0; k < COMB_LANES; ++k) {
+		reverb->comb_store[k] = store[k];
+	}
+	reverb->comb_pos = (reverb->comb_pos + n) & (reverb->comb_rows - 1);
+}
+
+// Apply one allpass stage to n samples of x in place.
+static void allpass_block(float* buffer, int len, int* index, float* x, int n) {
+	int idx = *index;
+	while (n > 0) {
+		const int run = n < len - idx ? n : len - idx;
+		float* slot = buffer + idx;
+		for (int i = 0; i < run; ++i) {
+			const float delayed = slot[i];
+			const float in = x[i];
+			slot[i] = in + delayed * ALLPASS_FEEDBACK;
+			x[i] = delayed - in;
+		}
+		idx += run;
+		if (idx == len) {
+			idx = 0;
+		}
+		x += run;
+		n -= run;
+	}
+	*index = idx;
+}
+
+static inline int16_t to_int16(float v) {
+	v *= 32768.0f;
+	v = v < -32768.0f ? -32768.0f : v;
+	v = v > 32767.0f ? 32767.0f : v;
+	return static_cast<int16_t>(v);
+}
+
+SPATIALIZER_EXPORT void reverb_process_int16(Reverb* reverb, int16_t* samples, int frames) {
+	if (!reverb || !samples || frames <= 0) {
+		return;
+	}
+#ifdef REVERB_HAVE_MXCSR
+	// Decaying feedback loops reach denormals, which are very slow on x86;
+	// verblib flushed them by hand per sample
+	const unsigned int csr = _mm_getcsr();
+	_mm_setcsr(csr | 0x8040);  // FTZ | DAZ
+#endif
+	const float to_float = 1.0f / 32768.0f;
+	float input[BLOCK_FRAMES];
+	float left[BLOCK_FRAMES];
+	float right[BLOCK_FRAMES];
+	while (frames > 0) {
+		const int n = frames < BLOCK_FRAMES ? frames : BLOCK_FRAMES;
+		for (int i = 0; i < n; ++i) {
+			input[i] = (static_cast<float>(samples[2 * i]) + static_cast<float>(samples[2 * i + 1]))
+				* (to_float * FIXED_GAIN);
+		}
+		comb_block(reverb, input, n, left, right);
+		for (int i = 0; i < NUM_ALLPASSES; ++i) {
+			allpass_block(reverb->allpass_buf[0][i], reverb->allpass_len[0][i], &reverb->allpass_idx[0][i], left, n);
+			allpass_block(reverb->allpass_buf[1][i], reverb->allpass_len[1][i], &reverb->allpass_idx[1][i], right, n);
+		}
+		const float wet1 = reverb->wet1;
+		const float wet2 = reverb->wet2;
+		const float dry = reverb->dry * to_float;
+		for (int i = 0; i < n; ++i) {
+			const float dry_left = static_cast<float>(samples[2 * i]) * dry;
+			const float dry_right = static_cast<float>(samples[2 * i + 1]) * dry;
+			samples[2 * i] = to_int16(left[i] * wet1 + right[i] * wet2 + dry_left);
+			samples[2 * i + 1] = to_int16(right[i] * wet1 + left[i] * wet2 + dry_right);
+		}
+		samples += 2 * n;
+		frames -= n;
+	}
+#ifdef REVERB_HAVE_MXCSR
+	_mm_setcsr(csr);
+#endif
+}
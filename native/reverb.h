@@ -0,0 +1,39 @@
+// Classic Unspoken reverb for spatializer.dll.
+//
+// A block-processing rewrite of the verblib (Freeverb) reverb that v1 linked in
+// main.obj: the same 8 comb + 4 allpass network per channel, stereo spread and
+// parameter mapping, so the add-on's RoomSize/Damping/WetLevel/DryLevel/Width
+// settings sound as they did before EFX. It runs on the stereo int16 output of
+// the OpenAL Soft loopback render instead of an EFX effect slot.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#define SPATIALIZER_EXPORT extern "C" __declspec(dllexport)
+#else
+#define SPATIALIZER_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+struct Reverb;
+
+// Allocate a reverb for sample_rate with every delay line silent, or null on failure.
+SPATIALIZER_EXPORT Reverb* reverb_create(int sample_rate);
+
+SPATIALIZER_EXPORT void reverb_destroy(Reverb* reverb);
+
+// Set the normalized (0.0-1.0) parameters, mapped as verblib_set_room_size,
+// verblib_set_damping, verblib_set_wet, verblib_set_dry and verblib_set_width did.
+SPATIALIZER_EXPORT void reverb_set_params(Reverb* reverb, float room_size, float damping, float wet,
+	float dry, float width);
+
+// Clear every delay line and filter state.
+SPATIALIZER_EXPORT void reverb_reset(Reverb* reverb);
+
+// Process frames of interleaved stereo int16 PCM in place.
+SPATIALIZER_EXPORT void reverb_process_int16(Reverb* reverb, int16_t* samples, int frames);
+
+// Bytes allocated for the reverb, delay lines included.
+SPATIALIZER_EXPORT size_t reverb_memory_bytes(const Reverb* reverb);
@@ -0,0 +1,333 @@
+// Native batch spatializer for Unspoken-ng.
+//
+// Replaces the per-sample Python loops on the render path (gain, clamp and
+// float/int16 conversion) with a single tight loop, and drives the OpenAL Soft
+// loopback render from native code so the Python side only passes pointers.
+// ctypes releases the GIL for the duration of every call into this DLL.
+//
+// This keeps the export surface of the old steam_audio.dll (process_sound,
+// free_output_sound) but talks to the soft_oal.dll that openal_audio.py has
+// already loaded: initialize_spatializer() takes the AL entry points Python
+// resolved from that module, so device, context, source and buffer handles
+// created from Python are valid here, and the DLL never has to find the module
+// by path.
+//
+// The classic reverb (reverb.cpp) is linked into the same DLL and, when a job
+// asks for it, runs on the rendered output before it is returned.
+//
+// process_batch() renders many jobs back to back in one call into a single
+// caller-owned arena, cutting each job's reverb tail where it falls silent the
+// way openal_audio.TailTrimmer does.
+//
+// Build (x64 Native Tools prompt):
+//   cl /nologo /O2 /EHsc /MT /LD native\spatializer.cpp native\reverb.cpp /Fe:addon\globalPlugins\Unspoken\spatializer.dll
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "reverb.h"
+
+// OpenAL constants, matching the ones in openal_audio.py.
+static const int AL_FORMAT_MONO16 = 0x1101;
+static const int AL_BUFFER = 0x1009;
+static const int AL_POSITION = 0x1004;
+static const int AL_GAIN = 0x100A;
+static const int AL_AUXILIARY_SEND_FILTER = 0x20006;
+static const int AL_FILTER_NULL = 0x0000;
+
+// Sample formats accepted in RenderJob::sample_format.
+static const int SAMPLE_FORMAT_INT16 = 0;
+static const int SAMPLE_FORMAT_FLOAT32 = 1;
+
+typedef void (*alSourcei_t)(unsigned, int, int);
+typedef void (*alSourcef_t)(unsigned, int, float);
+typedef void (*alSource3f_t)(unsigned, int, float, float, float);
+typedef void (*alSource3i_t)(unsigned, int, int, int, int);
+typedef void (*alSourcePlay_t)(unsigned);
+typedef void (*alSourceStop_t)(unsigned);
+typedef void (*alBufferData_t)(unsigned, int, const void*, int, int);
+typedef void (*alcRenderSamplesSOFT_t)(void*, void*, int);
+
+// AL entry points. Layout is mirrored by the OpenALApi ctypes.Structure in
+// native_spatializer.py; keep the two in sync.
+struct OpenALApi {
+	alSourcei_t alSourcei;
+	alSourcef_t alSourcef;
+	alSource3f_t alSource3f;
+	alSource3i_t alSource3i;
+	alSourcePlay_t alSourcePlay;
+	alSourceStop_t alSourceStop;
+	alBufferData_t alBufferData;
+	alcRenderSamplesSOFT_t alcRenderSamplesSOFT;
+};
+
+static OpenALApi g_al;
+static bool g_initialized = false;
+
+// One render request. Layout is mirrored by the RenderJob ctypes.Structure in
+// native_spatializer.py; keep the two in sync.
+struct RenderJob {
+	void* device;           // ALCdevice* of the loopback device
+	unsigned source;        // AL source to play through
+	unsigned buffer;        // AL buffer to play; samples are uploaded into it first
+	const void* samples;    // mono input PCM, or null if buffer already holds the sound
+	int sample_format;      // SAMPLE_FORMAT_INT16 or SAMPLE_FORMAT_FLOAT32
+	int num_frames;         // input frame count, at the output rate when samples is null
+	int sample_rate;        // input sample rate
+	float gain;             // scales float32 samples before upload; int16 samples at 1.0 are uploaded as is
+	float source_gain;      // AL_GAIN on the source (dry level)
+	float position[3];      // AL_POSITION unit vector
+	unsigned effect_slot;   // auxiliary slot for the reverb send, 0 for none
+	int tail_frames;        // extra frames rendered after the input ends
+	Reverb* reverb;         // classic reverb applied to the output, or null
+};
+
+// Where a batch job's reverb tail is cut. Layout is mirrored by the TailCut
+// ctypes.Structure in native_spatializer.py; keep the two in sync.
+struct TailCut {
+	double threshold;       // mean square per sample below which a block is quiet
+	int hold_frames;        // quiet frames in a row that end the tail
+	int block_frames;       // frames per measured block, and per tail extension
+	int ceiling_frames;     // longest tail ever rendered; 0 when reverb is off
+};
+
+// Branch-free clamp so the conversion loops below vectorize.
+static inline float clamp_sample(float v) {
+	v = v < -32768.0f ? -32768.0f : v;
+	return v > 32767.0f ? 32767.0f : v;
+}
+
+static void convert_int16(const int16_t* in, int n, float gain, int16_t* out) {
+	for (int i = 0; i < n; ++i) {
+		out[i] = static_cast<int16_t>(clamp_sample(static_cast<float>(in[i]) * gain));
+	}
+}
+
+static void convert_float32(const float* in, int n, float gain, int16_t* out) {
+	const float scale = gain * 32767.0f;
+	for (int i = 0; i < n; ++i) {
+		out[i] = static_cast<int16_t>(clamp_sample(in[i] * scale));
+	}
+}
+
+// Take the AL entry points resolved by Python from the loaded OpenAL Soft module.
+// Returns 1 on success, 0 if any of them is missing.
+SPATIALIZER_EXPORT int initialize_spatializer(const OpenALApi* entry_points) {
+	if (g_initialized) {
+		return 1;
+	}
+	if (!entry_points) {
+		return 0;
+	}
+	const OpenALApi& api = *entry_points;
+	if (!api.alSourcei || !api.alSourcef || !api.alSource3f || !api.alSource3i || !api.alSourcePlay
+		|| !api.alSourceStop || !api.alBufferData || !api.alcRenderSamplesSOFT) {
+		return 0;
+	}
+	g_al = api;
+	g_initialized = true;
+	return 1;
+}
+
+// Convert and upload (unless the buffer is preloaded), position and start one sound.
+// The job's classic reverb starts from silence, so no earlier render's tail
+// carries into it. Returns the frames to render for it (input plus tail), or 0
+// on failure.
+static int start_job(const RenderJob* job) {
+	const int n = job->num_frames;
+	if (job->reverb) {
+		reverb_reset(job->reverb);
+	}
+	// A superseded stream may leave the source playing; buffers can only be
+	// (re)attached to a stopped source.
+	g_al.alSourceStop(job->source);
+	if (job->samples) {
+		// The add-on folds gain into AL_GAIN, so its int16 input needs no conversion
+		const void* upload = job->samples;
+		int16_t* pcm = nullptr;
+		if (job->sample_format != SAMPLE_FORMAT_INT16 || job->gain != 1.0f) {
+			pcm = static_cast<int16_t*>(std::malloc(static_cast<size_t>(n) * sizeof(int16_t)));
+			if (!pcm) {
+				return 0;
+			}
+			if (job->sample_format == SAMPLE_FORMAT_FLOAT32) {
+				convert_float32(static_cast<const float*>(job->samples), n, job->gain, pcm);
+			} else if (job->sample_format == SAMPLE_FORMAT_INT16) {
+				convert_int16(static_cast<const int16_t*>(job->samples), n, job->gain, pcm);
+			} else {
+				std::free(pcm);
+				return 0;
+			}
+			upload = pcm;
+		}
+
+		// alBufferData fails on a buffer still attached to a source, even a stopped one.
+		g_al.alSourcei(job->source, AL_BUFFER, 0);
+		g_al.alBufferData(job->buffer, AL_FORMAT_MONO16, upload, n * static_cast<int>(sizeof(int16_t)), job->sample_rate);
+		std::free(pcm);
+	}
+	g_al.alSourcei(job->source, AL_BUFFER, static_cast<int>(job->buffer));
+	g_al.alSource3f(job->source, AL_POSITION, job->position[0], job->position[1], job->position[2]);
+	g_al.alSourcef(job->source, AL_GAIN, job->source_gain);
+	g_al.alSource3i(job->source, AL_AUXILIARY_SEND_FILTER, static_cast<int>(job->effect_slot), 0, AL_FILTER_NULL);
+	g_al.alSourcePlay(job->source);
+	return n + (job->tail_frames > 0 ? job->tail_frames : 0);
+}
+
+// Render total_frames of the started job into out, then stop the source.
+static void render_job(const RenderJob* job, int16_t* out, int total_frames) {
+	g_al.alcRenderSamplesSOFT(job->device, out, total_frames);
+	g_al.alSourceStop(job->source);
+	if (job->reverb) {
+		reverb_process_int16(job->reverb, out, total_frames);
+	}
+}
+
+// Render one sound (see start_job).
+// On success *out_samples receives a malloc'd interleaved stereo int16 buffer of
+// *out_frames frames, owned by the caller and released with free_output_sound().
+// Returns 1 on success, 0 on failure. The caller serializes calls per context.
+SPATIALIZER_EXPORT int process_sound(const RenderJob* job, int16_t** out_samples, int* out_frames) {
+	if (!g_initialized || !job || !out_samples || !out_frames || job->num_frames <= 0) {
+		return 0;
+	}
+	const int total_frames = start_job(job);
+	if (total_frames <= 0) {
+		return 0;
+	}
+	int16_t* out = static_cast<int16_t*>(std::malloc(static_cast<size_t>(total_frames) * 2 * sizeof(int16_t)));
+	if (!out) {
+		g_al.alSourceStop(job->source);
+		return 0;
+	}
+	render_job(job, out, total_frames);
+
+	*out_samples = out;
+	*out_frames = total_frames;
+	return 1;
+}
+
+// Render one sound into the caller's interleaved stereo int16 buffer of
+// capacity_frames frames, so a caller that keeps a buffer per context renders
+// without any allocation here. *out_frames receives the frames written.
+// Returns 1 on success, 0 on failure or if the render would not fit.
+SPATIALIZER_EXPORT int process_sound_into(const RenderJob* job, int16_t* out, int capacity_frames, int* out_frames) {
+	if (!g_initialized || !job || !out || !out_frames || job->num_frames <= 0) {
+		return 0;
+	}
+	if (job->num_frames + (job->tail_frames > 0 ? job->tail_frames : 0) > capacity_frames) {
+		return 0;
+	}
+	const int total_frames = start_job(job);
+	if (total_frames <= 0) {
+		return 0;
+	}
+	render_job(job, out, total_frames);
+	*out_frames = total_frames;
+	return 1;
+}
+
+// Scans consecutive stretches of a tail in block_frames blocks, as
+// TailTrimmer.scan() does: a block is quiet when its sum of squares is below
+// threshold times its sample count, and the tail is done once quiet blocks add
+// up to hold_frames in a row. quiet_start is then where that run began.
+struct TailScan {
+	int position = 0;
+	int quiet_start = -1;
+
+	bool scan(const TailCut* cut, const int16_t* pcm, int frames) {
+		for (int start = 0; start < frames; start += cut->block_frames) {
+			const int count = frames - start < cut->block_frames ? frames - start : cut->block_frames;
+			const int16_t* block = pcm + static_cast<size_t>(start) * 2;
+			double energy = 0.0;
+			for (int i = 0; i < count * 2; ++i) {
+				const double v = block[i];
+				energy += v * v;
+			}
+			if (energy < cut->threshold * (count * 2)) {
+				if (quiet_start < 0) {
+					quiet_start = position;
+				}
+				if (position + count - quiet_start >= cut->hold_frames) {
+					return true;
+				}
+			} else {
+				quiet_start = -1;
+			}
+			position += count;
+		}
+		return false;
+	}
+};
+
+// Render the started job's tail on from its first tail_frames, block_frames at
+// a time, until it stays quiet or reaches the ceiling. Returns the tail length
+// up to the start of the final quiet run.
+static int finish_tail(const RenderJob* job, const TailCut* cut, int16_t* out) {
+	const int ceiling = cut->ceiling_frames;
+	int tail = job->tail_frames;
+	TailScan trimmer;
+	bool done = trimmer.scan(cut, out + static_cast<size_t>(job->num_frames) * 2, tail);
+	while (!done && tail < ceiling) {
+		const int frames = cut->block_frames < ceiling - tail ? cut->block_frames : ceiling - tail;
+		int16_t* block = out + static_cast<size_t>(job->num_frames + tail) * 2;
+		g_al.alcRenderSamplesSOFT(job->device, block, frames);
+		if (job->reverb) {
+			reverb_process_int16(job->reverb, block, frames);
+		}
+		tail += frames;
+		done = trimmer.scan(cut, block, frames);
+	}
+	return done ? trimmer.quiet_start : tail;
+}
+
+// Render count jobs back to back into arena, an interleaved stereo int16 buffer
+// of capacity_frames frames. Each job renders its input plus tail_frames, then
+// (with a nonzero ceiling) extends and trims its tail as finish_tail() does, so
+// it matches a single render cut by TailTrimmer. The next job then starts with
+// the EFX tail below the floor and, like every job, a silent classic reverb.
+// offsets[i] and frames[i] receive job i's start and length in arena frames;
+// frames[i] is 0 for a job that could not start.
+// A job is only started while its input plus the whole ceiling fits in what is
+// left of the arena. Returns the number of jobs processed, less than count if
+// the arena filled up. The caller serializes calls per context.
+SPATIALIZER_EXPORT int process_batch(const RenderJob* jobs, int count, const TailCut* cut, int16_t* arena,
+	int capacity_frames, int* offsets, int* frames) {
+	if (!g_initialized || !jobs || !cut || !arena || !offsets || !frames || cut->block_frames <= 0) {
+		return 0;
+	}
+	const int ceiling = cut->ceiling_frames > 0 ? cut->ceiling_frames : 0;
+	int used = 0;
+	int processed = 0;
+	for (; processed < count; ++processed) {
+		RenderJob job = jobs[processed];
+		offsets[processed] = used;
+		frames[processed] = 0;
+		if (job.num_frames <= 0) {
+			continue;
+		}
+		if (job.num_frames + ceiling > capacity_frames - used) {
+			break;
+		}
+		job.tail_frames = job.tail_frames < 0 ? 0 : (job.tail_frames > ceiling ? ceiling : job.tail_frames);
+		const int total_frames = start_job(&job);
+		if (total_frames <= 0) {
+			continue;
+		}
+		int16_t* out = arena + static_cast<size_t>(used) * 2;
+		g_al.alcRenderSamplesSOFT(job.device, out, total_frames);
+		if (job.reverb) {
+			reverb_process_int16(job.reverb, out, total_frames);
+		}
+		const int length = ceiling > 0 ? job.num_frames + finish_tail(&job, cut, out) : total_frames;
+		g_al.alSourceStop(job.source);
+		frames[processed] = length;
+		used += length;
+	}
+	return processed;
+}
+
+SPATIALIZER_EXPORT void free_output_sound(int16_t* samples) {
+	std::free(samples);
+}
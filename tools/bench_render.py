@@ -0,0 +1,341 @@
+"""
+Offline benchmark for the Unspoken render engine.
+
+Runs OpenALLoopback outside NVDA: the add-on package is loaded without its
+__init__ (which needs NVDA), and openal_audio falls back to the logging module.
+Every bundled sounds/*.wav is rendered across a grid of angles and reverb
+presets, on one or more threads, through each render path:
+
+    process_sound  float32 input, uploaded and rendered per call (pure ctypes)
+    pcm16          int16 input uploaded as is, synth volume in AL_GAIN (spatializer.dll if loaded)
+    bank           preloaded sound bank buffer, gain in AL_GAIN (the add-on's path)
+    batch          the same bank renders, --batch-size at a time through render_batch
+                   (one native call per batch with spatializer.dll)
+    earcon         render_earcon, i.e. bank renders served from the render cache
+
+For each path and concurrency level it reports renders/sec, mean and p95 render
+time, mean and total time spent waiting for a loopback context lock, and Python
+bytes allocated per render (tracemalloc peak, measured in a separate
+single-threaded pass so tracing does not skew timings). On the batch path a
+render is one job, each taking an even share of its batch call. Peak RSS of the process is printed at
+the end.
+
+The v1 steam_audio/verblib process_sound in main.obj has no Python binding in
+this tree and is not benchmarked; spatializer.dll (native/spatializer.cpp)
+replaces it and is measured whenever it is present next to the add-on.
+
+Example:
+    python tools/bench_render.py --threads 1,2,4 --iterations 200
+    python tools/bench_render.py --openal /usr/lib/libopenal.so.1 --no-native
+"""
+
+import argparse
+import array
+import ctypes
+import importlib
+import os
+import sys
+import threading
+import time
+import tracemalloc
+import types
+import wave
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ADDON_DIR = os.path.join(REPO_ROOT, "addon", "globalPlugins", "Unspoken")
+SOUNDS_DIR = os.path.join(ADDON_DIR, "sounds")
+
+# name -> (room_size, damping, wet_level, dry_level, width), or None for reverb off.
+# "default" matches the add-on's config defaults.
+REVERB_PRESETS = {
+    "off": None,
+    "default": (0.10, 1.00, 0.09, 0.30, 1.00),
+    "large": (0.60, 0.50, 0.30, 0.30, 1.00),
+}
+
+PATHS = ("process_sound", "pcm16", "bank", "batch", "earcon")
+
+
+def load_engine_module():
+    """Import Unspoken.openal_audio without running the package's NVDA-only __init__."""
+    package = types.ModuleType("Unspoken")
+    package.__path__ = [ADDON_DIR]
+    sys.modules.setdefault("Unspoken", package)
+    return importlib.import_module("Unspoken.openal_audio")
+
+
+class LockWaitStats:
+    """Total time spent waiting to acquire any of the engine's context locks."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.wait_total = 0.0
+        self.acquisitions = 0
+
+    def add(self, waited):
+        with self._lock:
+            self.wait_total += waited
+            self.acquisitions += 1
+
+    def reset(self):
+        with self._lock:
+            self.wait_total = 0.0
+            self.acquisitions = 0
+
+
+class WaitTimingLock:
+    """Lock wrapper reporting the time callers spend waiting to acquire it into a LockWaitStats."""
+
+    def __init__(self, lock, stats):
+        self._lock = lock
+        self._stats = stats
+
+    def acquire(self, blocking=True, timeout=-1):
+        start = time.perf_counter()
+        acquired = self._lock.acquire(blocking, timeout)
+        if acquired and blocking:
+            self._stats.add(time.perf_counter() - start)
+        return acquired
+
+    def release(self):
+        self._lock.release()
+
+    __enter__ = acquire
+
+    def __exit__(self, *exc):
+        self._lock.release()
+
+
+def peak_rss_bytes():
+    """Peak resident set size of this process, or None if it cannot be read."""
+    if sys.platform == "win32":
+        class PROCESS_MEMORY_COUNTERS(ctypes.Structure):
+            _fields_ = [
+                ("cb", ctypes.c_ulong),
+                ("PageFaultCount", ctypes.c_ulong),
+                ("PeakWorkingSetSize", ctypes.c_size_t),
+                ("WorkingSetSize", ctypes.c_size_t),
+                ("QuotaPeakPagedPoolUsage", ctypes.c_size_t),
+                ("QuotaPagedPoolUsage", ctypes.c_size_t),
+                ("QuotaPeakNonPagedPoolUsage", ctypes.c_size_t),
+                ("QuotaNonPagedPoolUsage", ctypes.c_size_t),
+                ("PagefileUsage", ctypes.c_size_t),
+                ("PeakPagefileUsage", ctypes.c_size_t),
+            ]
+
+        counters = PROCESS_MEMORY_COUNTERS()
+        counters.cb = ctypes.sizeof(counters)
+        process = ctypes.windll.kernel32.GetCurrentProcess()
+        if not ctypes.windll.psapi.GetProcessMemoryInfo(process, ctypes.byref(counters), counters.cb):
+            return None
+        return counters.PeakWorkingSetSize
+    try:
+        import resource
+    except ImportError:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # ru_maxrss is in bytes on macOS and kilobytes elsewhere
+    return peak if sys.platform == "darwin" else peak * 1024
+
+
+def read_wav_pcm16(path):
+    """Return the left channel of a 16-bit wav as array('h'), or None."""
+    with wave.open(path, "rb") as wav_file:
+        if wav_file.getsampwidth() != 2:
+            return None
+        channels = wav_file.getnchannels()
+        samples = array.array("h")
+        samples.frombytes(wav_file.readframes(wav_file.getnframes()))
+    if sys.byteorder == "big":
+        samples.byteswap()
+    return samples[::channels] if channels != 1 else samples
+
+
+def build_jobs(sound_ids, angle_step):
+    """Cartesian grid of (sound_id, angle_x, angle_y) over the add-on's angle ranges."""
+    jobs = []
+    angle_x = -90.0
+    while angle_x <= 90.0:
+        for angle_y in (-40.0, -15.0, 10.0):
+            for sound_id in sound_ids:
+                jobs.append((sound_id, angle_x, angle_y))
+        angle_x += angle_step
+    return jobs
+
+
+class Renderer:
+    """Maps a path name onto the engine call for one (sound, angle) job."""
+
+    def __init__(self, engine, pcm16, floats, gain, batch_size=1):
+        self.engine = engine
+        self.pcm16 = pcm16
+        self.floats = floats
+        self.gain = gain
+        self.batch_size = batch_size
+
+    def jobs_per_call(self, path):
+        return self.batch_size if path == "batch" else 1
+
+    def render_many(self, path, jobs):
+        """Render a list of jobs in one call for batch, one by one otherwise; return the failure count."""
+        if path == "batch":
+            batch = self.engine.render_batch(
+                [(sound_id, angle_x, angle_y, self.gain) for sound_id, angle_x, angle_y in jobs]
+            )
+            return sum(1 for span in batch.spans if span is None)
+        return sum(1 for job in jobs if not self.render(path, *job))
+
+    def render(self, path, sound_id, angle_x, angle_y):
+        engine = self.engine
+        if path == "process_sound":
+            return engine.process_sound(self.floats[sound_id], angle_x, angle_y)
+        if path == "pcm16":
+            return engine.process_pcm16(self.pcm16[sound_id], self.gain, angle_x, angle_y)
+        if path == "bank":
+            return engine.render_bank_sound(sound_id, self.gain, angle_x, angle_y)
+        return engine.render_earcon(sound_id, angle_x, angle_y, self.gain)
+
+
+def run_timed(renderer, path, jobs, iterations, threads, wait_stats):
+    """Render iterations jobs split across threads; return (wall seconds, per-render seconds)."""
+    durations = []
+    durations_lock = threading.Lock()
+    failures = []
+
+    per_call = renderer.jobs_per_call(path)
+
+    def worker(index):
+        local = []
+        for first in range(index * per_call, iterations, threads * per_call):
+            chunk = [jobs[i % len(jobs)] for i in range(first, min(first + per_call, iterations))]
+            start = time.perf_counter()
+            failed = renderer.render_many(path, chunk)
+            if failed:
+                failures.extend([path] * failed)
+            spent = (time.perf_counter() - start) / len(chunk)
+            local.extend([spent] * len(chunk))
+        with durations_lock:
+            durations.extend(local)
+
+    wait_stats.reset()
+    workers = [threading.Thread(target=worker, args=(i,)) for i in range(threads)]
+    start = time.perf_counter()
+    for thread in workers:
+        thread.start()
+    for thread in workers:
+        thread.join()
+    wall = time.perf_counter() - start
+    if failures:
+        print(f"  warning: {len(failures)} failed renders on {path}", file=sys.stderr)
+    return wall, sorted(durations)
+
+
+def measure_alloc(renderer, path, jobs, samples):
+    """Mean tracemalloc peak, in bytes, of one render (one job of a batch) on this thread."""
+    total = 0
+    per_call = renderer.jobs_per_call(path)
+    tracemalloc.start()
+    try:
+        for i in range(samples):
+            chunk = [jobs[(i * per_call + k) % len(jobs)] for k in range(per_call)]
+            tracemalloc.reset_peak()
+            base = tracemalloc.get_traced_memory()[0]
+            renderer.render_many(path, chunk)
+            total += (tracemalloc.get_traced_memory()[1] - base) / per_call
+    finally:
+        tracemalloc.stop()
+    return total / samples if samples else 0.0
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--openal", help="OpenAL Soft library (default: soft_oal.dll in the add-on)")
+    parser.add_argument("--sounds", default=SOUNDS_DIR, help="directory of wav files to render")
+    parser.add_argument("--paths", default=",".join(PATHS), help="comma separated render paths")
+    parser.add_argument("--reverb", default=",".join(REVERB_PRESETS), help="comma separated reverb presets")
+    parser.add_argument("--threads", default="1,2,4", help="comma separated concurrency levels")
+    parser.add_argument("--iterations", type=int, default=200, help="renders per measurement")
+    parser.add_argument("--angle-step", type=float, default=15.0, help="azimuth grid step in degrees")
+    parser.add_argument("--gain", type=float, default=1.0, help="synth-tracking volume passed to renders")
+    parser.add_argument("--alloc-samples", type=int, default=20, help="renders traced for allocation size")
+    parser.add_argument("--batch-size", type=int, default=16, help="jobs per render_batch call on the batch path")
+    parser.add_argument("--contexts", type=int, default=None, help="loopback contexts (default: engine default)")
+    parser.add_argument("--no-native", action="store_true", help="ignore spatializer.dll")
+    args = parser.parse_args(argv)
+
+    openal_audio = load_engine_module()
+    engine = openal_audio.OpenALLoopback(args.openal)
+    if engine.dll is None:
+        print("OpenAL Soft could not be loaded; pass --openal", file=sys.stderr)
+        return 1
+    if args.no_native:
+        engine._native = None
+    init_args = {} if args.contexts is None else {"context_count": args.contexts}
+    if not engine.initialize(**init_args):
+        print("OpenAL loopback initialization failed", file=sys.stderr)
+        return 1
+    wait_stats = LockWaitStats()
+    for ctx in engine._contexts:
+        ctx.lock = WaitTimingLock(ctx.lock, wait_stats)
+
+    pcm16 = {}
+    floats = {}
+    for name in sorted(os.listdir(args.sounds)):
+        if not name.lower().endswith(".wav"):
+            continue
+        path = os.path.join(args.sounds, name)
+        samples = read_wav_pcm16(path)
+        if samples is None or not engine.load_sound(name, path):
+            print(f"  skipping {name}", file=sys.stderr)
+            continue
+        pcm16[name] = samples
+        floats[name] = array.array("f", (s / 32768.0 for s in samples))
+    if not pcm16:
+        print(f"No 16-bit wav files found in {args.sounds}", file=sys.stderr)
+        return 1
+
+    jobs = build_jobs(sorted(pcm16), args.angle_step)
+    renderer = Renderer(engine, pcm16, floats, args.gain, max(1, args.batch_size))
+    thread_counts = [int(n) for n in args.threads.split(",")]
+    print(
+        f"{len(pcm16)} sounds, {len(jobs)} grid positions, {args.iterations} renders per row, "
+        f"{len(engine._contexts)} loopback contexts, "
+        f"native spatializer: {'yes' if engine._native is not None else 'no'}, "
+        f"PCM kernels: {openal_audio.pcm_kernels.BACKEND}"
+    )
+    print(
+        f"{'path':<14}{'reverb':<9}{'threads':>7}{'renders/s':>11}{'mean ms':>9}{'p95 ms':>8}"
+        f"{'wait ms':>9}{'wait s':>8}{'alloc B':>10}"
+    )
+    try:
+        for preset in args.reverb.split(","):
+            params = REVERB_PRESETS[preset]
+            engine.enable_reverb(params is not None)
+            if params is not None:
+                engine.set_reverb_settings(*params)
+            for path in args.paths.split(","):
+                engine.render_cache.clear()
+                # Warm-up so one-off costs (first upload, cache fill) stay out of the timings
+                renderer.render_many(path, jobs[: len(pcm16)])
+                alloc = measure_alloc(renderer, path, jobs, args.alloc_samples)
+                for threads in thread_counts:
+                    wall, durations = run_timed(renderer, path, jobs, args.iterations, threads, wait_stats)
+                    count = len(durations)
+                    mean_ms = sum(durations) / count * 1000.0
+                    p95_ms = durations[min(count - 1, int(count * 0.95))] * 1000.0
+                    wait_ms = wait_stats.wait_total / wait_stats.acquisitions * 1000.0 if wait_stats.acquisitions else 0.0
+                    print(
+                        f"{path:<14}{preset:<9}{threads:>7}{count / wall:>11.1f}{mean_ms:>9.3f}"
+                        f"{p95_ms:>8.3f}{wait_ms:>9.3f}{wait_stats.wait_total:>8.3f}{alloc:>10.0f}"
+                    )
+    finally:
+        engine.cleanup()
+
+    rss = peak_rss_bytes()
+    if rss is not None:
+        print(f"peak RSS: {rss / (1024 * 1024):.1f} MiB")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())